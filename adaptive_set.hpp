@@ -0,0 +1,514 @@
+#ifndef ADAPTIVE_SET_HPP
+#define ADAPTIVE_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <initializer_list>
+#include <iterator>
+#include <array>
+#include <vector>
+#include <variant>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <concepts>
+#include <bit>
+
+#include "avl_tree.hpp"
+
+
+namespace adt {
+
+    /* ------------------------------------------------Adaptive Set------------------------------------------------- */
+    // An ordered set that picks its layout from its contents:
+    //  - up to `InlineCapacity` values live in a sorted array inside the set itself (no allocation at all);
+    //  - integral values whose range is dense enough live in a bitset over [low, low + 64 * words);
+    //  - everything else lives in a balanced `avl_tree`.
+    // The representation is re-evaluated as the set grows and shrinks, with hysteresis so that a set hovering
+    // around a threshold does not convert back and forth. All layouts share one API and one iterator type.
+    template<class T, class Allocator = std::allocator<T>, std::size_t InlineCapacity = 16>
+    class adaptive_set {
+        static_assert(InlineCapacity > 0, "the inline array must hold at least one value");
+
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using value_type = T;
+
+        using key_type = T;
+
+        using allocator_type = Allocator;
+
+        using size_type = std::size_t;
+
+        using difference_type = std::ptrdiff_t;
+
+        using reference = value_type&;
+
+        using const_reference = const value_type&;
+
+        using tree_type = avl_tree<T, Allocator>;
+
+        enum class layout : std::uint8_t { inline_array, bitset, tree };
+
+        // A bitset is used while it needs at most this many bits per value, i.e. 1/density
+        static constexpr size_type max_bits_per_value = 64;
+
+        static constexpr size_type inline_capacity = InlineCapacity;
+
+    protected:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        static constexpr bool dense_capable = std::is_integral_v<T>;
+
+        using _WordAllocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<std::uint64_t>;
+
+        struct _Inline {
+            std::array<value_type, InlineCapacity> values;
+
+            size_type count = 0;
+        };
+
+        struct _Dense {
+            // Bit `i` of the set stands for the value `low + i`
+            value_type low;
+
+            std::vector<std::uint64_t, _WordAllocator> words;
+
+            size_type count = 0;
+        };
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        std::variant<_Inline, _Dense, tree_type> storage;
+
+        allocator_type allocator;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] static constexpr std::uint64_t _distance(value_type low, value_type value) noexcept {
+            // Unsigned arithmetic, so that distances across the whole range of a signed type do not overflow
+            using unsigned_type = std::make_unsigned_t<value_type>;
+            return static_cast<std::uint64_t>(static_cast<unsigned_type>(value) - static_cast<unsigned_type>(low));
+        }
+
+        [[nodiscard]] static constexpr value_type _offset(value_type low, std::uint64_t distance) noexcept {
+            using unsigned_type = std::make_unsigned_t<value_type>;
+            return static_cast<value_type>(static_cast<unsigned_type>(static_cast<unsigned_type>(low) + distance));
+        }
+
+        // Number of values in [low, high]; a span of the whole 64-bit range saturates, which is never dense
+        [[nodiscard]] static constexpr std::uint64_t _span(value_type low, value_type high) noexcept {
+            const std::uint64_t distance = _distance(low, high);
+            return distance == std::numeric_limits<std::uint64_t>::max() ? distance : distance + 1;
+        }
+
+        [[nodiscard]] static constexpr bool _dense_enough(std::uint64_t span, size_type count) noexcept {
+            return span / max_bits_per_value <= count;
+        }
+
+        // Calls `visitor(value)` for every value, in order, whatever the layout
+        template<class Visitor>
+        void _for_each(Visitor visitor) const {
+            if (const _Inline* small = std::get_if<_Inline>(&this->storage)) {
+                for (size_type i = 0; i < small->count; ++i) {
+                    visitor(small->values[i]);
+                }
+            } else if (const tree_type* tree = std::get_if<tree_type>(&this->storage)) {
+                for (const_reference value : *tree) {
+                    visitor(value);
+                }
+            } else if constexpr (dense_capable) {
+                const _Dense& dense = std::get<_Dense>(this->storage);
+                for (size_type word = 0; word < dense.words.size(); ++word) {
+                    for (std::uint64_t bits = dense.words[word]; bits != 0; bits &= bits - 1) {
+                        visitor(_offset(dense.low, word * 64 + static_cast<std::uint64_t>(std::countr_zero(bits))));
+                    }
+                }
+            }
+        }
+
+        void _to_tree() {
+            tree_type tree(this->allocator);
+            this->_for_each([&](const_reference value) { tree.insert(value); });
+            this->storage.template emplace<tree_type>(std::move(tree));
+        }
+
+        void _to_inline() {
+            _Inline small;
+            this->_for_each([&](const_reference value) { small.values[small.count++] = value; });
+            this->storage.template emplace<_Inline>(std::move(small));
+        }
+
+        void _to_dense(value_type low, value_type high) requires dense_capable {
+            _Dense dense{low, std::vector<std::uint64_t, _WordAllocator>(_WordAllocator(this->allocator)), 0};
+            dense.words.assign(_distance(low, high) / 64 + 1, 0);
+            this->_for_each([&](const_reference value) {
+                const std::uint64_t bit = _distance(low, value);
+                dense.words[bit / 64] |= std::uint64_t(1) << (bit % 64);
+                ++dense.count;
+            });
+            this->storage.template emplace<_Dense>(std::move(dense));
+        }
+
+        // Moves a set that has outgrown its inline array to whichever layout suits its values
+        void _grow_out_of_inline(const_reference incoming) {
+            if constexpr (dense_capable) {
+                const _Inline& small = std::get<_Inline>(this->storage);
+                const value_type low = std::min(small.values[0], incoming);
+                const value_type high = std::max(small.values[small.count - 1], incoming);
+                if (_dense_enough(_span(low, high), small.count + 1)) {
+                    this->_to_dense(low, high);
+                    return;
+                }
+            }
+
+            this->_to_tree();
+        }
+
+        [[nodiscard]] static value_type _dense_max(const _Dense& dense) noexcept requires dense_capable {
+            // The largest value held, found from the last non-empty word (the bitset may extend past it)
+            for (size_type word = dense.words.size(); word > 0; --word) {
+                if (dense.words[word - 1] != 0) {
+                    return _offset(dense.low, (word - 1) * 64 + 63 - static_cast<std::uint64_t>(std::countl_zero(dense.words[word - 1])));
+                }
+            }
+
+            return dense.low;
+        }
+
+        bool _insert_dense(const_reference value) requires dense_capable {
+            _Dense& dense = std::get<_Dense>(this->storage);
+            const std::uint64_t span = dense.words.size() * 64;
+
+            if (value < dense.low || _distance(dense.low, value) >= span) {
+                // Extend the bitset towards the new value if the result is still dense, or give up on it
+                const value_type low = std::min(dense.low, value);
+                const value_type high = std::max(this->_dense_max(dense), value);
+                if (!_dense_enough(_span(low, high), dense.count + 1)) {
+                    this->_to_tree();
+                    return std::get<tree_type>(this->storage).insert(value).second;
+                }
+
+                const std::uint64_t shift = _distance(low, dense.low);
+                std::vector<std::uint64_t, _WordAllocator> words(_distance(low, high) / 64 + 1, 0, _WordAllocator(this->allocator));
+                for (size_type word = 0; word < dense.words.size(); ++word) {
+                    for (std::uint64_t bits = dense.words[word]; bits != 0; bits &= bits - 1) {
+                        const std::uint64_t bit = shift + word * 64 + static_cast<std::uint64_t>(std::countr_zero(bits));
+                        words[bit / 64] |= std::uint64_t(1) << (bit % 64);
+                    }
+                }
+                dense.low = low;
+                dense.words = std::move(words);
+            }
+
+            const std::uint64_t bit = _distance(dense.low, value);
+            std::uint64_t& word = dense.words[bit / 64];
+            const std::uint64_t mask = std::uint64_t(1) << (bit % 64);
+            if ((word & mask) != 0) {
+                return false;
+            }
+
+            word |= mask;
+            ++dense.count;
+            return true;
+        }
+
+        void _after_tree_insert() {
+            // Large trees are checked again at every doubling, in case their values have filled in a dense range
+            if constexpr (dense_capable) {
+                const tree_type& tree = std::get<tree_type>(this->storage);
+                if (std::has_single_bit(tree.size())) {
+                    const value_type low = *tree.begin();
+                    const value_type high = *tree.rbegin();
+                    if (_dense_enough(_span(low, high), tree.size())) {
+                        this->_to_dense(low, high);
+                    }
+                }
+            }
+        }
+
+        void _after_erase() {
+            // Fall back to the inline array only well below its capacity, so the boundary does not thrash
+            if (!std::holds_alternative<_Inline>(this->storage) && this->size() <= InlineCapacity / 2) {
+                this->_to_inline();
+                return;
+            }
+
+            if constexpr (dense_capable) {
+                // A bitset that has become four times too sparse turns into a tree
+                if (const _Dense* dense = std::get_if<_Dense>(&this->storage)) {
+                    if (dense->words.size() * 64 / (4 * max_bits_per_value) > dense->count) {
+                        this->_to_tree();
+                    }
+                }
+            }
+        }
+
+    public:
+        /* --------------------------------------------Constant Iterator-------------------------------------------- */
+        // Holds a copy of the current value (bitsets store no values to point at), so it is an input iterator
+        class const_iterator {
+        private:
+            /* --------------------------------------------Friends-------------------------------------------------- */
+            friend class adaptive_set;
+
+        protected:
+            /* ---------------------------------------------Fields-------------------------------------------------- */
+            const adaptive_set* set;
+
+            // Index into the inline array, or bit index into the bitset
+            std::uint64_t position;
+
+            typename tree_type::const_iterator node;
+
+            typename adaptive_set::value_type current;
+
+            bool valid;
+
+            /* --------------------------------------------Methods-------------------------------------------------- */
+            void _settle() {
+                // Load the value at `position`/`node`, or become the end iterator
+                this->valid = false;
+
+                if (const _Inline* small = std::get_if<_Inline>(&this->set->storage)) {
+                    if (this->position < small->count) {
+                        this->current = small->values[this->position];
+                        this->valid = true;
+                    }
+                } else if (std::holds_alternative<tree_type>(this->set->storage)) {
+                    if (this->node != nullptr) {
+                        this->current = *this->node;
+                        this->valid = true;
+                    }
+                } else if constexpr (dense_capable) {
+                    const _Dense& dense = std::get<_Dense>(this->set->storage);
+                    for (std::uint64_t word = this->position / 64; word < dense.words.size(); ++word) {
+                        std::uint64_t bits = dense.words[word];
+                        if (word == this->position / 64) {
+                            bits &= ~std::uint64_t(0) << (this->position % 64);
+                        }
+                        if (bits != 0) {
+                            this->position = word * 64 + static_cast<std::uint64_t>(std::countr_zero(bits));
+                            this->current = _offset(dense.low, this->position);
+                            this->valid = true;
+                            return;
+                        }
+                    }
+                }
+            }
+
+            const_iterator(const adaptive_set* set, std::uint64_t position, typename tree_type::const_iterator node)
+                : set(set), position(position), node(node), current(), valid(false) {
+                this->_settle();
+            }
+
+        public:
+            /* -------------------------------------------Definitions----------------------------------------------- */
+            using iterator_category = std::input_iterator_tag;
+
+            using value_type = typename adaptive_set::value_type;
+
+            using difference_type = typename adaptive_set::difference_type;
+
+            using reference = const value_type&;
+
+            using pointer = const value_type*;
+
+            /* ------------------------------------------Constructors----------------------------------------------- */
+            const_iterator() : set(nullptr), position(0), current(), valid(false) {}
+
+            /* ---------------------------------------Overloaded Operators------------------------------------------ */
+            [[nodiscard]] bool operator==(const const_iterator& other) const noexcept {
+                return this->valid == other.valid && (!this->valid || this->current == other.current);
+            }
+
+            [[nodiscard]] reference operator*() const noexcept { return this->current; }
+
+            [[nodiscard]] pointer operator->() const noexcept { return &this->current; }
+
+            const_iterator& operator++() {
+                if (std::holds_alternative<tree_type>(this->set->storage)) {
+                    ++this->node;
+                } else {
+                    ++this->position;
+                }
+
+                this->_settle();
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator previous = *this;
+                ++(*this);
+                return previous;
+            }
+
+        };
+
+        using iterator = const_iterator;
+
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        adaptive_set() : storage(std::in_place_type<_Inline>) {}
+
+        explicit adaptive_set(const allocator_type& allocator)
+            : storage(std::in_place_type<_Inline>), allocator(allocator) {}
+
+        adaptive_set(std::initializer_list<value_type> values, const allocator_type& allocator = allocator_type())
+            : adaptive_set(allocator) {
+            this->insert(values);
+        }
+
+        adaptive_set(const adaptive_set&) = default;
+
+        adaptive_set(adaptive_set&&) noexcept = default;
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~adaptive_set() noexcept = default;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        adaptive_set& operator=(const adaptive_set&) = default;
+
+        adaptive_set& operator=(adaptive_set&&) = default;
+
+        [[nodiscard]] bool operator==(const adaptive_set& other) const {
+            return this->size() == other.size() && std::equal(this->begin(), this->end(), other.begin());
+        }
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] layout current_layout() const noexcept { return static_cast<layout>(this->storage.index()); }
+
+        [[nodiscard]] size_type size() const noexcept {
+            if (const _Inline* small = std::get_if<_Inline>(&this->storage)) {
+                return small->count;
+            }
+            if (const _Dense* dense = std::get_if<_Dense>(&this->storage)) {
+                return dense->count;
+            }
+            return std::get<tree_type>(this->storage).size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept { return this->size() == 0; }
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept { return this->allocator; }
+
+        [[nodiscard]] const_iterator begin() const {
+            if (const tree_type* tree = std::get_if<tree_type>(&this->storage)) {
+                return const_iterator(this, 0, tree->begin());
+            }
+            return const_iterator(this, 0, {});
+        }
+
+        [[nodiscard]] const_iterator end() const noexcept { return const_iterator(); }
+
+        [[nodiscard]] const_iterator cbegin() const { return this->begin(); }
+
+        [[nodiscard]] const_iterator cend() const noexcept { return this->end(); }
+
+        void clear() noexcept { this->storage.template emplace<_Inline>(); }
+
+        void insert(std::initializer_list<value_type> values) {
+            for (const_reference value : values) {
+                this->insert(value);
+            }
+        }
+
+        bool insert(const_reference value) {
+            if (_Inline* small = std::get_if<_Inline>(&this->storage)) {
+                value_type* end = small->values.data() + small->count;
+                value_type* position = std::lower_bound(small->values.data(), end, value);
+                if (position != end && !(value < *position)) {
+                    return false;
+                }
+
+                if (small->count < InlineCapacity) {
+                    std::move_backward(position, end, end + 1);
+                    *position = value;
+                    ++small->count;
+                    return true;
+                }
+
+                this->_grow_out_of_inline(value);
+            }
+
+            if constexpr (dense_capable) {
+                if (std::holds_alternative<_Dense>(this->storage)) {
+                    return this->_insert_dense(value);
+                }
+            }
+
+            tree_type& tree = std::get<tree_type>(this->storage);
+            if (!tree.insert(value).second) {
+                return false;
+            }
+
+            this->_after_tree_insert();
+            return true;
+        }
+
+        bool erase(const_reference value) {
+            bool erased = false;
+
+            if (_Inline* small = std::get_if<_Inline>(&this->storage)) {
+                value_type* end = small->values.data() + small->count;
+                value_type* position = std::lower_bound(small->values.data(), end, value);
+                if (position != end && !(value < *position)) {
+                    std::move(position + 1, end, position);
+                    --small->count;
+                    erased = true;
+                }
+            } else if (tree_type* tree = std::get_if<tree_type>(&this->storage)) {
+                erased = tree->erase(value) == 1;
+            } else if constexpr (dense_capable) {
+                _Dense& dense = std::get<_Dense>(this->storage);
+                if (!(value < dense.low) && _distance(dense.low, value) < dense.words.size() * 64) {
+                    const std::uint64_t bit = _distance(dense.low, value);
+                    const std::uint64_t mask = std::uint64_t(1) << (bit % 64);
+                    if ((dense.words[bit / 64] & mask) != 0) {
+                        dense.words[bit / 64] &= ~mask;
+                        --dense.count;
+                        erased = true;
+                    }
+                }
+            }
+
+            if (erased) {
+                this->_after_erase();
+            }
+
+            return erased;
+        }
+
+        [[nodiscard]] bool contains(const_reference value) const {
+            if (const _Inline* small = std::get_if<_Inline>(&this->storage)) {
+                return std::binary_search(small->values.data(), small->values.data() + small->count, value);
+            }
+
+            if (const tree_type* tree = std::get_if<tree_type>(&this->storage)) {
+                return tree->contains(value);
+            }
+
+            if constexpr (dense_capable) {
+                const _Dense& dense = std::get<_Dense>(this->storage);
+                if (value < dense.low || _distance(dense.low, value) >= dense.words.size() * 64) {
+                    return false;
+                }
+
+                const std::uint64_t bit = _distance(dense.low, value);
+                return (dense.words[bit / 64] >> (bit % 64)) & 1;
+            }
+
+            return false;
+        }
+
+    };
+
+    namespace pmr {
+
+        template<class T, std::size_t InlineCapacity = 16>
+        using adaptive_set = adt::adaptive_set<T, std::pmr::polymorphic_allocator<T>, InlineCapacity>;
+
+    } // pmr
+
+} // adt
+
+
+#endif // ADAPTIVE_SET_HPP
@@ -0,0 +1,972 @@
+#ifndef ART_SET_HPP
+#define ART_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <concepts>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "string_key.hpp"
+
+
+namespace adt {
+
+    /* -------------------------------------------------ART Traits-------------------------------------------------- */
+    // Encodes a key as a byte string whose lexicographic order matches the key order. Encodings must be prefix-free
+    // (no key's encoding is a proper prefix of another's), which the radix tree relies on.
+    template<class T>
+    struct art_traits;
+
+    template<std::integral T>
+    struct art_traits<T> {
+        static void encode(const T& key, std::string& bytes) {
+            // Big-endian, with the sign bit flipped so negative values order first. Every key has the same length,
+            // so the encoding is trivially prefix-free.
+            using unsigned_type = std::make_unsigned_t<T>;
+            unsigned_type bits = static_cast<unsigned_type>(key);
+            if constexpr (std::is_signed_v<T>) {
+                bits ^= unsigned_type(1) << (sizeof(T) * 8 - 1);
+            }
+
+            bytes.resize(sizeof(T));
+            for (std::size_t i = 0; i < sizeof(T); ++i) {
+                bytes[i] = static_cast<char>(bits >> (8 * (sizeof(T) - 1 - i)));
+            }
+        }
+    };
+
+    template<class T>
+    struct art_string_traits {
+        static void encode(const T& key, std::string& bytes) {
+            // Escape NUL as 00 FF and terminate with 00 00: the terminator cannot occur inside an encoding, which
+            // keeps the encodings prefix-free, and a string still orders before all of its extensions
+            const std::string_view text(key);
+            bytes.clear();
+            bytes.reserve(text.size() + 2);
+            for (const char byte : text) {
+                bytes.push_back(byte);
+                if (byte == '\0') {
+                    bytes.push_back(static_cast<char>(0xFF));
+                }
+            }
+            bytes.push_back('\0');
+            bytes.push_back('\0');
+        }
+    };
+
+    template<class CharTraits, class Allocator>
+    struct art_traits<std::basic_string<char, CharTraits, Allocator>>
+        : art_string_traits<std::basic_string<char, CharTraits, Allocator>> {};
+
+    template<>
+    struct art_traits<std::string_view> : art_string_traits<std::string_view> {};
+
+    template<>
+    struct art_traits<string_key> : art_string_traits<string_key> {};
+
+    /* --------------------------------------------------ART Set---------------------------------------------------- */
+    // An ordered set stored as an adaptive radix tree (Leis et al., ICDE 2013). Inner nodes branch on one byte of the
+    // encoded key and come in four sizes (4, 16, 48 and 256 children), growing and shrinking with their fan-out.
+    // Single-child chains are compressed into a per-node prefix; the first `max_prefix` bytes are kept inline and
+    // longer prefixes are verified against a leaf. Lookups cost O(key length), independent of the set's size.
+    template<class T, class Allocator = std::allocator<T>, class Traits = art_traits<T>>
+    class art_set {
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using value_type = T;
+
+        using key_type = T;
+
+        using allocator_type = Allocator;
+
+        using size_type = std::size_t;
+
+        using difference_type = std::ptrdiff_t;
+
+        using reference = value_type&;
+
+        using const_reference = const value_type&;
+
+        using traits_type = Traits;
+
+    protected:
+        /* ------------------------------------------------Nodes---------------------------------------------------- */
+        static constexpr size_type max_prefix = 8;
+
+        enum class _Type : std::uint8_t { node4, node16, node48, node256 };
+
+        struct _Inner {
+            _Type type;
+
+            std::uint16_t count;
+
+            std::uint32_t prefix_length;
+
+            std::uint8_t prefix[max_prefix];
+        };
+
+        struct _Node4 : _Inner {
+            std::uint8_t keys[4];
+
+            void* children[4];
+        };
+
+        struct _Node16 : _Inner {
+            std::uint8_t keys[16];
+
+            void* children[16];
+        };
+
+        struct _Node48 : _Inner {
+            // Slot + 1 of each byte's child, or 0 when the byte has none
+            std::uint8_t index[256];
+
+            void* children[48];
+        };
+
+        struct _Node256 : _Inner {
+            void* children[256];
+        };
+
+        // Over-aligned so the low pointer bit is always free for the leaf tag
+        struct alignas(alignof(value_type) < 2 ? 2 : alignof(value_type)) _Leaf {
+            value_type value;
+        };
+
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using allocator_traits = typename std::allocator_traits<allocator_type>;
+
+        template<class Node>
+        using _Allocator = typename allocator_traits::template rebind_alloc<Node>;
+
+        template<class Node>
+        using _AllocatorTraits = typename std::allocator_traits<_Allocator<Node>>;
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        // Children are either inner nodes or leaves; leaves are told apart by a set low pointer bit
+        void* root;
+
+        allocator_type allocator;
+
+        size_type sz;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] static bool _is_leaf(const void* child) noexcept {
+            return (reinterpret_cast<std::uintptr_t>(child) & 1) != 0;
+        }
+
+        [[nodiscard]] static _Leaf* _as_leaf(const void* child) noexcept {
+            return reinterpret_cast<_Leaf*>(reinterpret_cast<std::uintptr_t>(child) & ~std::uintptr_t(1));
+        }
+
+        [[nodiscard]] static void* _tag_leaf(_Leaf* leaf) noexcept {
+            return reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(leaf) | 1);
+        }
+
+        [[nodiscard]] static std::uint8_t _byte(const std::string& key, size_type depth) noexcept {
+            return static_cast<std::uint8_t>(key[depth]);
+        }
+
+        template<class Node>
+        [[nodiscard]] Node* _allocate() {
+            _Allocator<Node> node_allocator(this->allocator);
+            Node* node = _AllocatorTraits<Node>::allocate(node_allocator, 1);
+            _AllocatorTraits<Node>::construct(node_allocator, node);
+            return node;
+        }
+
+        template<class Node>
+        void _deallocate(Node* node) noexcept {
+            _Allocator<Node> node_allocator(this->allocator);
+            _AllocatorTraits<Node>::destroy(node_allocator, node);
+            _AllocatorTraits<Node>::deallocate(node_allocator, node, 1);
+        }
+
+        template<class Node>
+        [[nodiscard]] Node* _make_inner(_Type type) {
+            Node* node = this->_allocate<Node>();
+            node->type = type;
+            node->count = 0;
+            node->prefix_length = 0;
+            return node;
+        }
+
+        [[nodiscard]] _Leaf* _make_leaf(const_reference value) {
+            _Allocator<_Leaf> leaf_allocator(this->allocator);
+            _Leaf* leaf = _AllocatorTraits<_Leaf>::allocate(leaf_allocator, 1);
+            _AllocatorTraits<_Leaf>::construct(leaf_allocator, leaf, _Leaf{value});
+            return leaf;
+        }
+
+        void _free_inner(_Inner* node) noexcept {
+            switch (node->type) {
+                case _Type::node4: this->_deallocate(static_cast<_Node4*>(node)); break;
+                case _Type::node16: this->_deallocate(static_cast<_Node16*>(node)); break;
+                case _Type::node48: this->_deallocate(static_cast<_Node48*>(node)); break;
+                case _Type::node256: this->_deallocate(static_cast<_Node256*>(node)); break;
+            }
+        }
+
+        void _free(void* child) noexcept {
+            if (child == nullptr) {
+                return;
+            }
+
+            if (_is_leaf(child)) {
+                this->_deallocate(_as_leaf(child));
+                return;
+            }
+
+            // Children first, then the node itself; the recursion is bounded by the key length
+            _Inner* node = static_cast<_Inner*>(child);
+            int position = 0;
+            for (void* next = _next_child(node, position); next != nullptr; next = _next_child(node, ++position)) {
+                this->_free(next);
+            }
+            this->_free_inner(node);
+        }
+
+        [[nodiscard]] void* _clone(const void* child) {
+            if (child == nullptr) {
+                return nullptr;
+            }
+
+            if (_is_leaf(child)) {
+                return _tag_leaf(this->_make_leaf(_as_leaf(child)->value));
+            }
+
+            const _Inner* node = static_cast<const _Inner*>(child);
+            switch (node->type) {
+                case _Type::node4: return this->_clone_inner(static_cast<const _Node4*>(node));
+                case _Type::node16: return this->_clone_inner(static_cast<const _Node16*>(node));
+                case _Type::node48: return this->_clone_inner(static_cast<const _Node48*>(node));
+                case _Type::node256: return this->_clone_inner(static_cast<const _Node256*>(node));
+            }
+
+            return nullptr;
+        }
+
+        template<class Node>
+        [[nodiscard]] Node* _clone_inner(const Node* node) {
+            Node* clone = this->_allocate<Node>();
+            *clone = *node;
+
+            for (void*& child : clone->children) {
+                child = this->_clone(child);
+            }
+
+            return clone;
+        }
+
+        /* ----------------------------------------------Navigation------------------------------------------------- */
+        [[nodiscard]] static void** _find_child(_Inner* node, std::uint8_t byte) noexcept {
+            switch (node->type) {
+                case _Type::node4: {
+                    _Node4* node4 = static_cast<_Node4*>(node);
+                    for (std::uint16_t i = 0; i < node4->count; ++i) {
+                        if (node4->keys[i] == byte) {
+                            return &node4->children[i];
+                        }
+                    }
+                    return nullptr;
+                }
+                case _Type::node16: {
+                    _Node16* node16 = static_cast<_Node16*>(node);
+#if defined(__SSE2__)
+                    // Compare all sixteen keys at once and keep the matches among the live slots
+                    const __m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(node16->keys)));
+                    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(matches)) & ((1u << node16->count) - 1);
+                    return mask != 0 ? &node16->children[__builtin_ctz(mask)] : nullptr;
+#else
+                    for (std::uint16_t i = 0; i < node16->count; ++i) {
+                        if (node16->keys[i] == byte) {
+                            return &node16->children[i];
+                        }
+                    }
+                    return nullptr;
+#endif
+                }
+                case _Type::node48: {
+                    _Node48* node48 = static_cast<_Node48*>(node);
+                    return node48->index[byte] != 0 ? &node48->children[node48->index[byte] - 1] : nullptr;
+                }
+                case _Type::node256: {
+                    _Node256* node256 = static_cast<_Node256*>(node);
+                    return node256->children[byte] != nullptr ? &node256->children[byte] : nullptr;
+                }
+            }
+
+            return nullptr;
+        }
+
+        // Returns the first child at or after `position` in key order, updating `position` to where it was found.
+        // Positions are slot numbers for the sorted node types and byte values for the indexed ones.
+        [[nodiscard]] static void* _next_child(const _Inner* node, int& position) noexcept {
+            switch (node->type) {
+                case _Type::node4: {
+                    const _Node4* node4 = static_cast<const _Node4*>(node);
+                    return position < node4->count ? node4->children[position] : nullptr;
+                }
+                case _Type::node16: {
+                    const _Node16* node16 = static_cast<const _Node16*>(node);
+                    return position < node16->count ? node16->children[position] : nullptr;
+                }
+                case _Type::node48: {
+                    const _Node48* node48 = static_cast<const _Node48*>(node);
+                    for (; position < 256; ++position) {
+                        if (node48->index[position] != 0) {
+                            return node48->children[node48->index[position] - 1];
+                        }
+                    }
+                    return nullptr;
+                }
+                case _Type::node256: {
+                    const _Node256* node256 = static_cast<const _Node256*>(node);
+                    for (; position < 256; ++position) {
+                        if (node256->children[position] != nullptr) {
+                            return node256->children[position];
+                        }
+                    }
+                    return nullptr;
+                }
+            }
+
+            return nullptr;
+        }
+
+        [[nodiscard]] static const _Leaf* _minimum(const void* child) noexcept {
+            while (child != nullptr && !_is_leaf(child)) {
+                int position = 0;
+                child = _next_child(static_cast<const _Inner*>(child), position);
+            }
+
+            return child != nullptr ? _as_leaf(child) : nullptr;
+        }
+
+        // Encodes into a per-thread buffer that keeps its capacity, so once it has grown to the longest key seen,
+        // encoding allocates nothing. `Buffer` tells apart encodings that must be alive at the same time: 0 for the
+        // key being looked up, 1 for a stored key compared against it.
+        template<int Buffer>
+        [[nodiscard]] static const std::string& _encode(const_reference value) {
+            thread_local std::string bytes;
+            traits_type::encode(value, bytes);
+            return bytes;
+        }
+
+        // Encodings are one-to-one, so comparing the values is the same as comparing their encodings
+        [[nodiscard]] static bool _leaf_matches(const _Leaf* leaf, const_reference value) {
+            return leaf->value == value;
+        }
+
+        // Number of leading prefix bytes of `node` that match `key` from `depth`, up to the full prefix length
+        [[nodiscard]] static size_type _prefix_mismatch(const _Inner* node, const std::string& key, size_type depth) {
+            const size_type available = key.size() - depth;
+            const size_type inline_length = std::min<size_type>({node->prefix_length, max_prefix, available});
+
+            size_type i = 0;
+            for (; i < inline_length; ++i) {
+                if (node->prefix[i] != _byte(key, depth + i)) {
+                    return i;
+                }
+            }
+
+            // The rest of a long prefix is only stored in the leaves, and all of them share it
+            if (node->prefix_length > max_prefix && i == max_prefix) {
+                const std::string& bytes = _encode<1>(_minimum(node)->value);
+
+                const size_type limit = std::min<size_type>(node->prefix_length, std::min(bytes.size(), key.size()) - depth);
+                for (; i < limit; ++i) {
+                    if (bytes[depth + i] != key[depth + i]) {
+                        return i;
+                    }
+                }
+            }
+
+            return i;
+        }
+
+        /* -----------------------------------------------Insertion------------------------------------------------- */
+        void _add_child(void** reference, _Inner* node, std::uint8_t byte, void* child) {
+            switch (node->type) {
+                case _Type::node4: {
+                    _Node4* node4 = static_cast<_Node4*>(node);
+                    if (node4->count < 4) {
+                        // Keep the keys sorted, which is what makes in-order iteration cheap
+                        int slot = 0;
+                        while (slot < node4->count && node4->keys[slot] < byte) {
+                            ++slot;
+                        }
+                        std::memmove(node4->keys + slot + 1, node4->keys + slot, node4->count - slot);
+                        std::memmove(node4->children + slot + 1, node4->children + slot, (node4->count - slot) * sizeof(void*));
+                        node4->keys[slot] = byte;
+                        node4->children[slot] = child;
+                        ++node4->count;
+                        return;
+                    }
+
+                    _Node16* node16 = this->_make_inner<_Node16>(_Type::node16);
+                    this->_copy_header(node16, node4);
+                    std::memcpy(node16->keys, node4->keys, 4);
+                    std::memcpy(node16->children, node4->children, 4 * sizeof(void*));
+                    *reference = node16;
+                    this->_deallocate(node4);
+                    this->_add_child(reference, node16, byte, child);
+                    return;
+                }
+                case _Type::node16: {
+                    _Node16* node16 = static_cast<_Node16*>(node);
+                    if (node16->count < 16) {
+                        int slot = 0;
+                        while (slot < node16->count && node16->keys[slot] < byte) {
+                            ++slot;
+                        }
+                        std::memmove(node16->keys + slot + 1, node16->keys + slot, node16->count - slot);
+                        std::memmove(node16->children + slot + 1, node16->children + slot, (node16->count - slot) * sizeof(void*));
+                        node16->keys[slot] = byte;
+                        node16->children[slot] = child;
+                        ++node16->count;
+                        return;
+                    }
+
+                    _Node48* node48 = this->_make_inner<_Node48>(_Type::node48);
+                    this->_copy_header(node48, node16);
+                    std::memset(node48->index, 0, sizeof(node48->index));
+                    for (int i = 0; i < 16; ++i) {
+                        node48->index[node16->keys[i]] = static_cast<std::uint8_t>(i + 1);
+                        node48->children[i] = node16->children[i];
+                    }
+                    *reference = node48;
+                    this->_deallocate(node16);
+                    this->_add_child(reference, node48, byte, child);
+                    return;
+                }
+                case _Type::node48: {
+                    _Node48* node48 = static_cast<_Node48*>(node);
+                    if (node48->count < 48) {
+                        // Slots are not kept in order (the index is), so any free one will do
+                        int slot = 0;
+                        while (node48->children[slot] != nullptr) {
+                            ++slot;
+                        }
+                        node48->children[slot] = child;
+                        node48->index[byte] = static_cast<std::uint8_t>(slot + 1);
+                        ++node48->count;
+                        return;
+                    }
+
+                    _Node256* node256 = this->_make_inner<_Node256>(_Type::node256);
+                    this->_copy_header(node256, node48);
+                    for (int i = 0; i < 256; ++i) {
+                        node256->children[i] = node48->index[i] != 0 ? node48->children[node48->index[i] - 1] : nullptr;
+                    }
+                    *reference = node256;
+                    this->_deallocate(node48);
+                    this->_add_child(reference, node256, byte, child);
+                    return;
+                }
+                case _Type::node256: {
+                    _Node256* node256 = static_cast<_Node256*>(node);
+                    node256->children[byte] = child;
+                    ++node256->count;
+                    return;
+                }
+            }
+        }
+
+        static void _copy_header(_Inner* target, const _Inner* source) noexcept {
+            target->count = source->count;
+            target->prefix_length = source->prefix_length;
+            std::memcpy(target->prefix, source->prefix, max_prefix);
+        }
+
+        bool _insert(void** reference, const std::string& key, size_type depth, const_reference value) {
+            void* child = *reference;
+
+            if (child == nullptr) {
+                *reference = _tag_leaf(this->_make_leaf(value));
+                return true;
+            }
+
+            if (_is_leaf(child)) {
+                if (_leaf_matches(_as_leaf(child), value)) {
+                    return false;
+                }
+                const std::string& existing = _encode<1>(_as_leaf(child)->value);
+
+                // Both keys continue past `depth`, since the encodings are prefix-free and different; branch where
+                // they first differ and compress the bytes they share into the new node's prefix
+                size_type shared = 0;
+                while (existing[depth + shared] == key[depth + shared]) {
+                    ++shared;
+                }
+
+                _Node4* branch = this->_make_inner<_Node4>(_Type::node4);
+                branch->prefix_length = static_cast<std::uint32_t>(shared);
+                std::memcpy(branch->prefix, key.data() + depth, std::min(shared, max_prefix));
+
+                void* slot = branch;
+                this->_add_child(&slot, branch, _byte(existing, depth + shared), child);
+                this->_add_child(&slot, branch, _byte(key, depth + shared), _tag_leaf(this->_make_leaf(value)));
+                *reference = slot;
+                return true;
+            }
+
+            _Inner* node = static_cast<_Inner*>(child);
+            if (node->prefix_length != 0) {
+                const size_type matched = _prefix_mismatch(node, key, depth);
+                if (matched < node->prefix_length) {
+                    // The key leaves the compressed path part-way, so split the prefix with a new parent
+                    _Node4* branch = this->_make_inner<_Node4>(_Type::node4);
+                    branch->prefix_length = static_cast<std::uint32_t>(matched);
+                    std::memcpy(branch->prefix, node->prefix, std::min(matched, max_prefix));
+
+                    void* slot = branch;
+                    if (node->prefix_length <= max_prefix) {
+                        this->_add_child(&slot, branch, node->prefix[matched], node);
+                        node->prefix_length -= static_cast<std::uint32_t>(matched + 1);
+                        std::memmove(node->prefix, node->prefix + matched + 1, std::min<size_type>(node->prefix_length, max_prefix));
+                    } else {
+                        // The byte to branch on may be past the inline bytes, so take it from a leaf
+                        const std::string& bytes = _encode<1>(_minimum(node)->value);
+                        node->prefix_length -= static_cast<std::uint32_t>(matched + 1);
+                        this->_add_child(&slot, branch, _byte(bytes, depth + matched), node);
+                        std::memcpy(node->prefix,
+                                    bytes.data() + depth + matched + 1,
+                                    std::min<size_type>(node->prefix_length, max_prefix));
+                    }
+
+                    this->_add_child(&slot, branch, _byte(key, depth + matched), _tag_leaf(this->_make_leaf(value)));
+                    *reference = slot;
+                    return true;
+                }
+
+                depth += node->prefix_length;
+            }
+
+            void** next = _find_child(node, _byte(key, depth));
+            if (next != nullptr) {
+                return this->_insert(next, key, depth + 1, value);
+            }
+
+            this->_add_child(reference, node, _byte(key, depth), _tag_leaf(this->_make_leaf(value)));
+            return true;
+        }
+
+        /* ------------------------------------------------Erasure-------------------------------------------------- */
+        void _remove_child(void** reference, _Inner* node, std::uint8_t byte, void** child) {
+            switch (node->type) {
+                case _Type::node4: {
+                    _Node4* node4 = static_cast<_Node4*>(node);
+                    const int slot = static_cast<int>(child - node4->children);
+                    std::memmove(node4->keys + slot, node4->keys + slot + 1, node4->count - 1 - slot);
+                    std::memmove(node4->children + slot, node4->children + slot + 1, (node4->count - 1 - slot) * sizeof(void*));
+                    --node4->count;
+                    node4->children[node4->count] = nullptr;
+
+                    if (node4->count == 1) {
+                        this->_collapse(reference, node4);
+                    }
+                    return;
+                }
+                case _Type::node16: {
+                    _Node16* node16 = static_cast<_Node16*>(node);
+                    const int slot = static_cast<int>(child - node16->children);
+                    std::memmove(node16->keys + slot, node16->keys + slot + 1, node16->count - 1 - slot);
+                    std::memmove(node16->children + slot, node16->children + slot + 1, (node16->count - 1 - slot) * sizeof(void*));
+                    --node16->count;
+                    node16->children[node16->count] = nullptr;
+
+                    if (node16->count == 3) {
+                        _Node4* node4 = this->_make_inner<_Node4>(_Type::node4);
+                        this->_copy_header(node4, node16);
+                        std::memcpy(node4->keys, node16->keys, 3);
+                        std::memcpy(node4->children, node16->children, 3 * sizeof(void*));
+                        *reference = node4;
+                        this->_deallocate(node16);
+                    }
+                    return;
+                }
+                case _Type::node48: {
+                    _Node48* node48 = static_cast<_Node48*>(node);
+                    node48->children[node48->index[byte] - 1] = nullptr;
+                    node48->index[byte] = 0;
+                    --node48->count;
+
+                    // Shrink with some slack below the growth threshold, so a node on the boundary does not thrash
+                    if (node48->count == 12) {
+                        _Node16* node16 = this->_make_inner<_Node16>(_Type::node16);
+                        this->_copy_header(node16, node48);
+                        int slot = 0;
+                        for (int i = 0; i < 256; ++i) {
+                            if (node48->index[i] != 0) {
+                                node16->keys[slot] = static_cast<std::uint8_t>(i);
+                                node16->children[slot] = node48->children[node48->index[i] - 1];
+                                ++slot;
+                            }
+                        }
+                        *reference = node16;
+                        this->_deallocate(node48);
+                    }
+                    return;
+                }
+                case _Type::node256: {
+                    _Node256* node256 = static_cast<_Node256*>(node);
+                    node256->children[byte] = nullptr;
+                    --node256->count;
+
+                    if (node256->count == 37) {
+                        _Node48* node48 = this->_make_inner<_Node48>(_Type::node48);
+                        this->_copy_header(node48, node256);
+                        std::memset(node48->index, 0, sizeof(node48->index));
+                        std::fill(std::begin(node48->children), std::end(node48->children), nullptr);
+                        int slot = 0;
+                        for (int i = 0; i < 256; ++i) {
+                            if (node256->children[i] != nullptr) {
+                                node48->children[slot] = node256->children[i];
+                                node48->index[i] = static_cast<std::uint8_t>(slot + 1);
+                                ++slot;
+                            }
+                        }
+                        *reference = node48;
+                        this->_deallocate(node256);
+                    }
+                    return;
+                }
+            }
+        }
+
+        void _collapse(void** reference, _Node4* node) {
+            // A node with one child is just a longer compressed path: fold it into the child
+            void* child = node->children[0];
+            if (!_is_leaf(child)) {
+                _Inner* inner = static_cast<_Inner*>(child);
+
+                std::uint8_t prefix[max_prefix];
+                size_type length = std::min<size_type>(node->prefix_length, max_prefix);
+                std::memcpy(prefix, node->prefix, length);
+                if (length < max_prefix) {
+                    prefix[length++] = node->keys[0];
+                }
+                for (size_type i = 0; length < max_prefix && i < std::min<size_type>(inner->prefix_length, max_prefix); ++i) {
+                    prefix[length++] = inner->prefix[i];
+                }
+
+                std::memcpy(inner->prefix, prefix, length);
+                inner->prefix_length += node->prefix_length + 1;
+            }
+
+            *reference = child;
+            this->_deallocate(node);
+        }
+
+        bool _erase(void** reference, const std::string& key, size_type depth, const_reference value) {
+            void* child = *reference;
+            if (child == nullptr) {
+                return false;
+            }
+
+            if (_is_leaf(child)) {
+                // Only reached when the root itself is a leaf
+                if (!_leaf_matches(_as_leaf(child), value)) {
+                    return false;
+                }
+
+                this->_deallocate(_as_leaf(child));
+                *reference = nullptr;
+                return true;
+            }
+
+            _Inner* node = static_cast<_Inner*>(child);
+            if (node->prefix_length != 0) {
+                if (_prefix_mismatch(node, key, depth) < node->prefix_length) {
+                    return false;
+                }
+                depth += node->prefix_length;
+            }
+
+            if (depth >= key.size()) {
+                return false;
+            }
+
+            void** next = _find_child(node, _byte(key, depth));
+            if (next == nullptr) {
+                return false;
+            }
+
+            if (_is_leaf(*next)) {
+                _Leaf* leaf = _as_leaf(*next);
+                if (!_leaf_matches(leaf, value)) {
+                    return false;
+                }
+
+                this->_remove_child(reference, node, _byte(key, depth), next);
+                this->_deallocate(leaf);
+                return true;
+            }
+
+            return this->_erase(next, key, depth + 1, value);
+        }
+
+    public:
+        /* --------------------------------------------Constant Iterator-------------------------------------------- */
+        class const_iterator {
+        private:
+            /* --------------------------------------------Friends-------------------------------------------------- */
+            friend class art_set;
+
+            /* -------------------------------------------Definitions----------------------------------------------- */
+            struct _Frame {
+                const _Inner* node;
+
+                int position;
+            };
+
+        protected:
+            /* ---------------------------------------------Fields-------------------------------------------------- */
+            std::vector<_Frame> path;
+
+            const _Leaf* leaf;
+
+            /* --------------------------------------------Methods-------------------------------------------------- */
+            void _descend(const void* child) {
+                // Walk to the smallest leaf below `child`, remembering where we came from
+                while (!_is_leaf(child)) {
+                    const _Inner* node = static_cast<const _Inner*>(child);
+                    int position = 0;
+                    child = _next_child(node, position);
+                    this->path.push_back({node, position});
+                }
+
+                this->leaf = _as_leaf(child);
+            }
+
+        public:
+            /* -------------------------------------------Definitions----------------------------------------------- */
+            using iterator_category = std::forward_iterator_tag;
+
+            using value_type = typename art_set::value_type;
+
+            using difference_type = typename art_set::difference_type;
+
+            using reference = const value_type&;
+
+            using pointer = const value_type*;
+
+            /* ------------------------------------------Constructors----------------------------------------------- */
+            const_iterator() noexcept : leaf(nullptr) {}
+
+            /* ---------------------------------------Overloaded Operators------------------------------------------ */
+            [[nodiscard]] bool operator==(const const_iterator& other) const noexcept { return this->leaf == other.leaf; }
+
+            [[nodiscard]] reference operator*() const noexcept { return this->leaf->value; }
+
+            [[nodiscard]] pointer operator->() const noexcept { return &(this->leaf->value); }
+
+            const_iterator& operator++() {
+                while (!this->path.empty()) {
+                    _Frame& frame = this->path.back();
+                    ++frame.position;
+
+                    const void* child = _next_child(frame.node, frame.position);
+                    if (child != nullptr) {
+                        this->_descend(child);
+                        return *this;
+                    }
+
+                    this->path.pop_back();
+                }
+
+                this->leaf = nullptr;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator previous = *this;
+                ++(*this);
+                return previous;
+            }
+
+        };
+
+        using iterator = const_iterator;
+
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        art_set() noexcept : root(nullptr), sz(0) {}
+
+        explicit art_set(const allocator_type& allocator) noexcept : root(nullptr), allocator(allocator), sz(0) {}
+
+        art_set(std::initializer_list<value_type> values, const allocator_type& allocator = allocator_type())
+            : root(nullptr), allocator(allocator), sz(0) {
+            this->insert(values);
+        }
+
+        art_set(const art_set& other)
+            : root(nullptr),
+              allocator(allocator_traits::select_on_container_copy_construction(other.allocator)),
+              sz(other.sz) {
+            this->root = this->_clone(other.root);
+        }
+
+        art_set(art_set&& other) noexcept
+            : root(std::exchange(other.root, nullptr)), allocator(std::move(other.allocator)), sz(std::exchange(other.sz, 0)) {}
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~art_set() noexcept { this->_free(this->root); }
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        art_set& operator=(const art_set& other) {
+            if (this == &other) {
+                return *this;
+            }
+
+            this->clear();
+            if constexpr (allocator_traits::propagate_on_container_copy_assignment::value) {
+                this->allocator = other.allocator;
+            }
+            this->root = this->_clone(other.root);
+            this->sz = other.sz;
+
+            return *this;
+        }
+
+        art_set& operator=(art_set&& other) noexcept(allocator_traits::propagate_on_container_move_assignment::value ||
+                                                      allocator_traits::is_always_equal::value) {
+            if (this == &other) {
+                return *this;
+            }
+
+            this->clear();
+            if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+                this->allocator = std::move(other.allocator);
+            } else if (this->allocator != other.allocator) {
+                this->root = this->_clone(other.root);
+                this->sz = other.sz;
+                return *this;
+            }
+
+            this->root = std::exchange(other.root, nullptr);
+            this->sz = std::exchange(other.sz, 0);
+
+            return *this;
+        }
+
+        [[nodiscard]] bool operator==(const art_set& other) const {
+            return this->sz == other.sz && std::equal(this->begin(), this->end(), other.begin());
+        }
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] size_type size() const noexcept { return this->sz; }
+
+        [[nodiscard]] bool empty() const noexcept { return this->sz == 0; }
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept { return this->allocator; }
+
+        [[nodiscard]] const_iterator begin() const {
+            const_iterator first;
+            if (this->root != nullptr) {
+                first._descend(this->root);
+            }
+            return first;
+        }
+
+        [[nodiscard]] const_iterator end() const noexcept { return const_iterator(); }
+
+        [[nodiscard]] const_iterator cbegin() const { return this->begin(); }
+
+        [[nodiscard]] const_iterator cend() const noexcept { return this->end(); }
+
+        void clear() noexcept {
+            this->_free(this->root);
+            this->root = nullptr;
+            this->sz = 0;
+        }
+
+        void insert(std::initializer_list<value_type> values) {
+            for (const_reference value : values) {
+                this->insert(value);
+            }
+        }
+
+        bool insert(const_reference value) {
+            const std::string& key = _encode<0>(value);
+
+            if (!this->_insert(&this->root, key, 0, value)) {
+                return false;
+            }
+
+            ++this->sz;
+            return true;
+        }
+
+        bool erase(const_reference value) {
+            const std::string& key = _encode<0>(value);
+
+            if (!this->_erase(&this->root, key, 0, value)) {
+                return false;
+            }
+
+            --this->sz;
+            return true;
+        }
+
+        [[nodiscard]] bool contains(const_reference value) const {
+            const std::string& key = _encode<0>(value);
+
+            // Only the inline prefix bytes are checked on the way down; the leaf comparison at the end also covers
+            // the bytes of long prefixes that were skipped
+            const void* child = this->root;
+            size_type depth = 0;
+            while (child != nullptr) {
+                if (_is_leaf(child)) {
+                    return _leaf_matches(_as_leaf(child), value);
+                }
+
+                _Inner* node = static_cast<_Inner*>(const_cast<void*>(child));
+                if (node->prefix_length != 0) {
+                    const size_type inline_length = std::min<size_type>({node->prefix_length, max_prefix, key.size() - depth});
+                    if (std::memcmp(node->prefix, key.data() + depth, inline_length) != 0) {
+                        return false;
+                    }
+                    depth += node->prefix_length;
+                }
+
+                if (depth >= key.size()) {
+                    return false;
+                }
+
+                void** next = _find_child(node, _byte(key, depth));
+                child = next != nullptr ? *next : nullptr;
+                ++depth;
+            }
+
+            return false;
+        }
+
+    };
+
+    namespace pmr {
+
+        template<class T, class Traits = art_traits<T>>
+        using art_set = adt::art_set<T, std::pmr::polymorphic_allocator<T>, Traits>;
+
+    } // pmr
+
+} // adt
+
+
+#endif // ART_SET_HPP
@@ -0,0 +1,272 @@
+#ifndef AVL_TREE_HPP
+#define AVL_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <initializer_list>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "binary_tree.hpp"
+
+
+namespace adt {
+
+    /* -------------------------------------------------AVL Balance------------------------------------------------- */
+    // Node augmentation for AVL trees: the subtree height, composed with any other augmentation the user asks for
+    template<class Augment = no_augment>
+    struct avl_balance : Augment {
+        /* ----------------------------------------------Fields----------------------------------------------------- */
+        std::int32_t height = 1;
+
+        /* ----------------------------------------------Methods---------------------------------------------------- */
+        template<class T>
+        static constexpr void update(avl_balance& self,
+                                     const T& value,
+                                     const avl_balance* left,
+                                     const avl_balance* right) noexcept {
+            self.height = 1 + std::max(left != nullptr ? left->height : 0, right != nullptr ? right->height : 0);
+
+            if constexpr (requires { Augment::update(self, value, left, right); }) {
+                Augment::update(self, value, left, right);
+            }
+        }
+
+        [[nodiscard]] constexpr bool operator==(const avl_balance&) const noexcept = default;
+
+    };
+
+    /* --------------------------------------------------AVL Tree--------------------------------------------------- */
+    // Height-balanced binary search tree: sibling subtrees differ in height by at most one, so the height stays below
+    // 1.44 log2(n + 2). Erasing a node with two children relinks its successor in its place instead of moving values,
+    // so iterators and node addresses of the remaining values stay valid.
+    template<class T, class Allocator = std::allocator<T>, class Augment = no_augment>
+    class avl_tree : public binary_tree<T, Allocator, avl_balance<Augment>> {
+    private:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using base = binary_tree<T, Allocator, avl_balance<Augment>>;
+
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::value_type;
+
+        using typename base::allocator_type;
+
+        using typename base::size_type;
+
+        using typename base::difference_type;
+
+        using typename base::reference;
+
+        using typename base::const_reference;
+
+        using typename base::iterator;
+
+        using typename base::const_iterator;
+
+    protected:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::_Node;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] static constexpr std::int32_t _height(const _Node* node) noexcept {
+            return node != nullptr ? node->augment.height : 0;
+        }
+
+        // Restores `node`'s height, rotating if its balance is off by two; returns the root of its subtree
+        constexpr _Node* _rebalance_at(_Node* node) noexcept {
+            this->_refresh(node);
+
+            const std::int32_t balance = _height(node->left) - _height(node->right);
+            if (balance > 1) {
+                if (_height(node->left->left) < _height(node->left->right)) {
+                    this->_rotate_left(node->left);
+                }
+                node = this->_rotate_right(node);
+            } else if (balance < -1) {
+                if (_height(node->right->right) < _height(node->right->left)) {
+                    this->_rotate_right(node->right);
+                }
+                node = this->_rotate_left(node);
+            }
+
+            return node;
+        }
+
+        constexpr void _rebalance(_Node* node) noexcept {
+            // Walk up from the lowest changed node, restoring heights and rotating wherever the balance is off by two
+            while (node != nullptr) {
+                node = this->_rebalance_at(node)->parent;
+            }
+        }
+
+        // Unlinks and frees `node` without rebalancing, returning the lowest node whose subtree lost height
+        constexpr _Node* _unlink_node(_Node* node) noexcept {
+            _Node* start;
+
+            if (node->left != nullptr && node->right != nullptr) {
+                // Move the successor node (not its value) into `node`'s place
+                _Node* successor = base::_leftmost(node->right);
+                if (successor->parent == node) {
+                    start = successor;
+                } else {
+                    start = successor->parent;
+                    this->_replace_child(successor->parent, successor, successor->right);
+                    successor->right = node->right;
+                    node->right->parent = successor;
+                }
+
+                this->_replace_child(node->parent, node, successor);
+                successor->left = node->left;
+                node->left->parent = successor;
+            } else {
+                start = node->parent;
+                this->_replace_child(node->parent, node, node->left != nullptr ? node->left : node->right);
+            }
+
+            // `node` is detached now, so it goes through `_destroy_node` as a lone root
+            node->parent = nullptr;
+            node->left = nullptr;
+            node->right = nullptr;
+            this->_destroy_node(node);
+
+            --this->sz;
+            return start;
+        }
+
+        constexpr void _erase_node(_Node* node) noexcept { this->_rebalance(this->_unlink_node(node)); }
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        constexpr avl_tree() noexcept : base() {}
+
+        constexpr explicit avl_tree(const allocator_type& allocator) noexcept : base(allocator) {}
+
+        constexpr avl_tree(std::initializer_list<value_type> values, const allocator_type& allocator = allocator_type())
+            : base(allocator) {
+            this->insert(values);
+        }
+
+        // Bulk construction: the input is sorted (by radix sort where possible) and built into a perfectly balanced
+        // tree in linear time, rather than inserted value by value
+        template<std::input_iterator InputIterator>
+        constexpr avl_tree(InputIterator first, InputIterator last, const allocator_type& allocator = allocator_type())
+            : base(allocator) {
+            std::vector<value_type> values(first, last);
+            this->_assign_unsorted(values);
+        }
+
+        constexpr avl_tree(const avl_tree&) = default;
+
+        constexpr avl_tree(avl_tree&&) noexcept = default;
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        constexpr ~avl_tree() noexcept override = default;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        constexpr avl_tree& operator=(const avl_tree&) = default;
+
+        constexpr avl_tree& operator=(avl_tree&&) = default;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] constexpr size_type height() const noexcept { return static_cast<size_type>(_height(this->root)); }
+
+        constexpr void clear() noexcept override {
+            this->_destroy_subtree(this->root);
+            this->root = nullptr;
+            this->sz = 0;
+            this->_record_reset();
+        }
+
+        constexpr void insert(std::initializer_list<value_type> values) noexcept override {
+            for (const_reference value : values) {
+                this->insert(value);
+            }
+        }
+
+        constexpr std::pair<iterator, bool> insert(const_reference value) noexcept {
+            _Node* parent = nullptr;
+            _Node* node = this->root;
+            while (node != nullptr) {
+                if (value < node->value) {
+                    parent = node;
+                    node = node->left;
+                } else if (node->value < value) {
+                    parent = node;
+                    node = node->right;
+                } else {
+                    return {base::_iterator_at(node), false};
+                }
+            }
+
+            node = this->_construct_node(value, parent, nullptr, nullptr);
+            if (parent == nullptr) {
+                this->root = node;
+            }
+
+            ++this->sz;
+            this->_rebalance(parent);
+            this->_record(change_kind::insert, value);
+
+            return {base::_iterator_at(node), true};
+        }
+
+        constexpr size_type erase(const_reference value) noexcept {
+            _Node* node = this->_find_node(value);
+            if (node == nullptr) {
+                return 0;
+            }
+
+            this->_record(change_kind::erase, value);
+            this->_erase_node(node);
+
+            return 1;
+        }
+
+        constexpr iterator erase(const_iterator position) noexcept {
+            _Node* node = base::_node_of(position);
+            _Node* next = base::_successor(node);
+
+            this->_record(change_kind::erase, node->value);
+            this->_erase_node(node);
+
+            return base::_iterator_at(next);
+        }
+
+        [[nodiscard]] constexpr bool contains(const_reference value) const noexcept override {
+            return this->_find_node(value) != nullptr;
+        }
+
+        [[nodiscard]] constexpr iterator find(const_reference value) noexcept {
+            return base::_iterator_at(this->_find_node(value));
+        }
+
+        [[nodiscard]] constexpr const_iterator find(const_reference value) const noexcept {
+            return base::_const_iterator_at(this->_find_node(value));
+        }
+
+        [[nodiscard]] constexpr const_iterator lower_bound(const_reference value) const noexcept {
+            return base::_const_iterator_at(this->_lower_bound_node(value, false));
+        }
+
+        [[nodiscard]] constexpr const_iterator upper_bound(const_reference value) const noexcept {
+            return base::_const_iterator_at(this->_lower_bound_node(value, true));
+        }
+
+    };
+
+    namespace pmr {
+
+        template<class T, class Augment = no_augment>
+        using avl_tree = adt::avl_tree<T, std::pmr::polymorphic_allocator<T>, Augment>;
+
+    } // pmr
+
+} // adt
+
+
+#endif // AVL_TREE_HPP
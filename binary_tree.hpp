@@ -7,16 +7,78 @@
 
 #include <cstddef>
 #include <memory>
+#include <memory_resource>
+#include <limits>
+#include <utility>
 #include <initializer_list>
 #include <stdexcept>
 #include <ranges>
 #include <compare>
 #include <concepts>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <bit>
+#include <span>
+#include <algorithm>
+#include <queue>
+
+#include "change_feed.hpp"
+#include "bloom_filter.hpp"
+#include "radix_sort.hpp"
 
 
 namespace adt {
 
-    template<class T, class Allocator = std::allocator<T>>
+    /* ------------------------------------------------Augmentations------------------------------------------------ */
+    // An augmentation is per-node data derived from a node's value and its children's augmentations. The tree
+    // recomputes it, bottom-up, whenever a node is linked, unlinked or rotated, by calling
+    // `Augment::update(self, value, left, right)` where `left`/`right` are null for missing children.
+    struct no_augment {
+        [[nodiscard]] constexpr bool operator==(const no_augment&) const noexcept = default;
+
+        [[nodiscard]] constexpr auto operator<=>(const no_augment&) const noexcept = default;
+    };
+
+    template<class T, class Hash = std::hash<T>>
+    struct merkle_digest {
+        /* ----------------------------------------------Fields----------------------------------------------------- */
+        // Sum (mod 2^64) of the mixed hashes of every value in the subtree. Because addition commutes, the digest
+        // only depends on the set of values and not on the shape of the tree, so rotations never change it and
+        // two trees holding the same values always agree on it.
+        std::uint64_t digest = 0;
+
+        /* ----------------------------------------------Methods---------------------------------------------------- */
+        [[nodiscard]] static constexpr std::uint64_t mix(const T& value) noexcept {
+            // splitmix64 finalizer, so that nearby hashes do not cancel out when summed
+            std::uint64_t x = static_cast<std::uint64_t>(Hash{}(value));
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebULL;
+            x ^= x >> 31;
+            return x;
+        }
+
+        static constexpr void update(merkle_digest& self,
+                                     const T& value,
+                                     const merkle_digest* left,
+                                     const merkle_digest* right) noexcept {
+            self.digest = mix(value);
+            if (left != nullptr) {
+                self.digest += left->digest;
+            }
+            if (right != nullptr) {
+                self.digest += right->digest;
+            }
+        }
+
+        [[nodiscard]] constexpr bool operator==(const merkle_digest&) const noexcept = default;
+
+        [[nodiscard]] constexpr auto operator<=>(const merkle_digest&) const noexcept = default;
+    };
+
+    template<class T, class Allocator = std::allocator<T>, class Augment = no_augment>
     class binary_tree {
     public:
         /* ----------------------------------------------Definitions------------------------------------------------ */
@@ -36,6 +98,8 @@ namespace adt {
 
         using const_pointer = typename std::allocator_traits<allocator_type>::const_pointer;
 
+        using augment_type = Augment;
+
     protected:
         /* -------------------------------------------------Node---------------------------------------------------- */
         struct _Node {
@@ -48,6 +112,8 @@ namespace adt {
 
             _Node* right;
 
+            [[no_unique_address]] augment_type augment;
+
             /* -----------------------------------------Constructors------------------------------------------------ */
             constexpr _Node() noexcept
                 : value(value_type()), parent(nullptr), left(nullptr), right(nullptr) {}
@@ -101,6 +167,18 @@ namespace adt {
 
         using node_allocator_traits = typename std::allocator_traits<_NodeAllocator>; 
 
+        using _SlotAllocator = typename allocator_traits::template rebind_alloc<_Node*>;
+
+        // A directory entry: a copy of a top-level node's value next to the node itself, or a null node for an empty
+        // position of the (usually incomplete) top levels
+        struct _Entry {
+            value_type key;
+
+            _Node* node;
+        };
+
+        using _EntryAllocator = typename allocator_traits::template rebind_alloc<_Entry>;
+
         /* ------------------------------------------------Fields--------------------------------------------------- */
         _Node* root;
 
@@ -110,11 +188,40 @@ namespace adt {
 
         size_type sz;
 
+        // Opt-in observer; not owned, and not carried over by copies or moves
+        change_feed<value_type>* feed = nullptr;
+
+        // Opt-in negative-lookup filter; not owned, and not carried over by copies or moves
+        bloom_filter<value_type>* bloom = nullptr;
+
+        // The accelerators below are allocated from the tree's allocator, which every constructor sets before them
+
+        // Opt-in direct-mapped cache of recently found nodes, indexed by value hash; empty when disabled
+        mutable std::vector<_Node*, _SlotAllocator> hot{_SlotAllocator(this->allocator)};
+
+        // Opt-in Eytzinger mirror of the top `directory_levels` levels, and the nodes hanging just below them; rebuilt
+        // by the first lookup after a change to those levels
+        mutable std::vector<_Entry, _EntryAllocator> directory{_EntryAllocator(this->allocator)};
+
+        mutable std::vector<_Node*, _SlotAllocator> fringe{_SlotAllocator(this->allocator)};
+
+        mutable bool stale = false;
+
+        std::size_t directory_levels = 0;
+
+        // Opt-in open-addressing (linear probing) table of every node, keyed by value; empty when disabled. Kept at
+        // most half full.
+        std::vector<_Node*, _SlotAllocator> index{_SlotAllocator(this->allocator)};
+
+        size_type indexed = 0;
+
         /* ------------------------------------------------Methods-------------------------------------------------- */
         constexpr _Node* _construct_node(const_reference value) noexcept {
             // Create the node
             _Node* node = node_allocator_traits::allocate(this->node_allocator, 1);
             node_allocator_traits::construct(this->node_allocator, node, value);
+            _refresh(node);
+            this->_index_insert(node);
 
             return node;
         }
@@ -126,6 +233,11 @@ namespace adt {
             // Create the node
             _Node* node = node_allocator_traits::allocate(this->node_allocator, 1);
             node_allocator_traits::construct(this->node_allocator, node, value, parent, left, right);
+            this->_reshaped(parent);
+            this->_index_insert(node);
+
+            // The node may have been linked below `parent`, so every ancestor's augmentation is now stale
+            _refresh_path(node);
 
             return node;
         }
@@ -135,11 +247,15 @@ namespace adt {
                 return nullptr;
             }
 
+            // Detached nodes are not part of the shape, so only the root and real unlinks count as changes to it
+            if (node->parent != nullptr || node == this->root) {
+                this->_reshaped(node->parent);
+            }
+
 	        // If the current node being deleted is the root node...
 	        if (node->parent == nullptr) {
 		        // Delete the root node and exit
-		        node_allocator_traits::destroy(this->node_allocator, node);
-                node_allocator_traits::deallocate(this->node_allocator, node, 1);
+		        this->_free_node(node);
 		        return nullptr;
 	        }
 
@@ -157,11 +273,800 @@ namespace adt {
 	        }
 
             // Delete the node
+            this->_free_node(node);
+
+            _refresh_path(parent);
+
+            return parent;
+        }
+
+        constexpr void _free_node(_Node* node) noexcept {
+            // Every node is released here, so this is the one place the lookup cache and index have to be told
+            this->_forget(node);
+            this->_index_erase(node);
+
             node_allocator_traits::destroy(this->node_allocator, node);
             node_allocator_traits::deallocate(this->node_allocator, node, 1);
+        }
+
+        constexpr void _destroy_subtree(_Node* node) noexcept {
+            if (node == nullptr) {
+                return;
+            }
+
+            if (node->parent != nullptr || node == this->root) {
+                this->_reshaped(node->parent);
+            }
+
+            // Detach the subtree from its parent so the walk below stops at `node`
+            _Node* top = node->parent;
+            if (top != nullptr) {
+                if (top->left == node) {
+                    top->left = nullptr;
+                } else if (top->right == node) {
+                    top->right = nullptr;
+                }
+                node->parent = nullptr;
+                _refresh_path(top);
+            }
+
+            // Walk the subtree in post-order using the parent pointers, so no stack is needed
+            while (node != nullptr) {
+                if (node->left != nullptr) {
+                    node = node->left;
+                } else if (node->right != nullptr) {
+                    node = node->right;
+                } else {
+                    // Unlink the leaf without refreshing its ancestors, since they are about to go too
+                    _Node* parent = node->parent;
+                    if (parent != nullptr) {
+                        if (parent->left == node) {
+                            parent->left = nullptr;
+                        } else {
+                            parent->right = nullptr;
+                        }
+                    }
+
+                    this->_free_node(node);
+                    node = parent;
+                }
+            }
+        }
+
+        // Whether the augmentation is derived from the subtree (and so must be refreshed), or is plain node data
+        static constexpr bool _derived_augment =
+            requires(augment_type& self, const value_type& value, const augment_type* child) {
+                augment_type::update(self, value, child, child);
+            };
+
+        static constexpr void _refresh(_Node* node) noexcept {
+            if constexpr (_derived_augment) {
+                augment_type::update(node->augment,
+                                     node->value,
+                                     node->left != nullptr ? &node->left->augment : nullptr,
+                                     node->right != nullptr ? &node->right->augment : nullptr);
+            }
+        }
+
+        static constexpr void _refresh_path(_Node* node) noexcept {
+            if constexpr (_derived_augment) {
+                while (node != nullptr) {
+                    _refresh(node);
+                    node = node->parent;
+                }
+            }
+        }
+
+        // Whether the augmentation carries a `dead` flag, marking lazily erased nodes that stay linked in the tree
+        // until a purge; searches and iteration step over them
+        static constexpr bool _tombstones = requires(const augment_type& augment) { bool(augment.dead); };
+
+        [[nodiscard]] static constexpr bool _dead(const _Node* node) noexcept {
+            if constexpr (_tombstones) {
+                return node->augment.dead;
+            } else {
+                return false;
+            }
+        }
+
+        constexpr void _replace_child(_Node* parent, _Node* old_child, _Node* new_child) noexcept {
+            this->_reshaped(parent);
+
+            if (parent == nullptr) {
+                this->root = new_child;
+            } else if (parent->left == old_child) {
+                parent->left = new_child;
+            } else {
+                parent->right = new_child;
+            }
+
+            if (new_child != nullptr) {
+                new_child->parent = parent;
+            }
+        }
+
+        constexpr _Node* _rotate_left(_Node* node) noexcept {
+            // `node`'s right child takes its place, and `node` becomes that child's left child
+            _Node* pivot = node->right;
+
+            node->right = pivot->left;
+            if (pivot->left != nullptr) {
+                pivot->left->parent = node;
+            }
+
+            this->_replace_child(node->parent, node, pivot);
+            pivot->left = node;
+            node->parent = pivot;
+
+            // Only `node` and `pivot` cover different values than before, so only they need refreshing
+            _refresh(node);
+            _refresh(pivot);
+
+            return pivot;
+        }
+
+        constexpr _Node* _rotate_right(_Node* node) noexcept {
+            // `node`'s left child takes its place, and `node` becomes that child's right child
+            _Node* pivot = node->left;
+
+            node->left = pivot->right;
+            if (pivot->right != nullptr) {
+                pivot->right->parent = node;
+            }
+
+            this->_replace_child(node->parent, node, pivot);
+            pivot->right = node;
+            node->parent = pivot;
+
+            _refresh(node);
+            _refresh(pivot);
+
+            return pivot;
+        }
+
+        // Node holding `value`, or null; tombstoned nodes count as absent
+        [[nodiscard]] constexpr _Node* _find_node(const_reference value) const noexcept {
+            _Node* node = this->_find_any_node(value);
+            return node != nullptr && !_dead(node) ? node : nullptr;
+        }
+
+        // Node holding `value`, tombstoned or not
+        [[nodiscard]] constexpr _Node* _find_any_node(const_reference value) const noexcept {
+            if constexpr (hashable<value_type>) {
+                if (!this->index.empty()) {
+                    return this->_index_find(value);
+                }
+            }
+
+            // Hot values are answered by the cache, and most absent values are turned away by the filter, each after
+            // one cache line, before the pointer chase
+            if (_Node* cached = this->_cached(value); cached != nullptr) {
+                return cached;
+            }
+
+            if (this->_filtered_out(value)) {
+                return nullptr;
+            }
+
+            _Node* node = this->root;
+            if (!this->directory.empty()) {
+                // The upper levels are searched in the contiguous directory; `node` is then where the search leaves it
+                std::size_t position = 1;
+                if (this->_descend_directory(value, position)) {
+                    _Node* found = this->directory[position - 1].node;
+                    this->_remember(found);
+                    return found;
+                }
+
+                const std::size_t count = this->directory.size();
+                node = position <= count ? nullptr : this->fringe[position - count - 1];
+            }
+
+            while (node != nullptr) {
+                if (value < node->value) {
+                    node = node->left;
+                } else if (node->value < value) {
+                    node = node->right;
+                } else {
+                    this->_remember(node);
+                    return node;
+                }
+            }
+
+            return nullptr;
+        }
+
+        [[nodiscard]] constexpr _Node* _lower_bound_node(const_reference value, bool strict) const noexcept {
+            // Find the first node whose value is `>= value` (or `> value` when `strict`)
+            _Node* node = this->root;
+            _Node* bound = nullptr;
+            while (node != nullptr) {
+                if (strict ? value < node->value : !(node->value < value)) {
+                    bound = node;
+                    node = node->left;
+                } else {
+                    node = node->right;
+                }
+            }
+
+            return _live(bound);
+        }
+
+        [[nodiscard]] static constexpr const _Node* _seek_node(const _Node* node, const_reference value) noexcept {
+            // Finger search for the first node `>= value`, starting from `node`: climb while the parent is still too
+            // small, then descend from the subtree we stopped in. Both legs are O(log d) for a node d steps ahead.
+            if (node == nullptr || !(node->value < value)) {
+                return _live(node);
+            }
+
+            while (node->parent != nullptr && node->parent->value < value) {
+                node = node->parent;
+            }
+
+            // Every value in `node`'s right subtree is below its parent, which is the fallback bound
+            const _Node* bound = node->parent;
+            node = node->right;
+            while (node != nullptr) {
+                if (node->value < value) {
+                    node = node->right;
+                } else {
+                    bound = node;
+                    node = node->left;
+                }
+            }
+
+            return _live(bound);
+        }
+
+        // Allocates an unlinked copy of `source` (value and augmented fields), releasing the memory if the copy throws
+        constexpr _Node* _copy_node(const _Node& source) {
+            _Node* node = node_allocator_traits::allocate(this->node_allocator, 1);
+            try {
+                node_allocator_traits::construct(this->node_allocator, node, source);
+            } catch (...) {
+                node_allocator_traits::deallocate(this->node_allocator, node, 1);
+                throw;
+            }
+
+            node->parent = nullptr;
+            node->left = nullptr;
+            node->right = nullptr;
+            return node;
+        }
+
+        constexpr _Node* _clone_subtree(const _Node* other) {
+            if (other == nullptr) {
+                return nullptr;
+            }
+
+            _Node* clone = this->_copy_node(*other);
+
+            // Every copy is linked under `clone` as soon as it exists, so if a later one throws the partial subtree
+            // is freed as a whole
+            try {
+                this->_index_insert(clone);
+
+                // Copy the rest of the subtree in pre-order, mirroring the walk in `other`
+                const _Node* source = other;
+                _Node* target = clone;
+                while (source != nullptr) {
+                    if (source->left != nullptr && target->left == nullptr) {
+                        _Node* child = this->_copy_node(*source->left);
+                        child->parent = target;
+                        target->left = child;
+                        this->_index_insert(child);
+
+                        source = source->left;
+                        target = child;
+                    } else if (source->right != nullptr && target->right == nullptr) {
+                        _Node* child = this->_copy_node(*source->right);
+                        child->parent = target;
+                        target->right = child;
+                        this->_index_insert(child);
+
+                        source = source->right;
+                        target = child;
+                    } else if (source == other) {
+                        // Both children of the subtree root have been copied
+                        break;
+                    } else {
+                        source = source->parent;
+                        target = target->parent;
+                    }
+                }
+            } catch (...) {
+                this->_destroy_subtree(clone);
+                throw;
+            }
+
+            return clone;
+        }
+
+        // Slot of `value` in a power-of-two table of `slots` entries
+        [[nodiscard]] static constexpr std::size_t _slot_of(const_reference value, std::size_t slots) noexcept {
+            // Fibonacci hashing: the high bits of the product are well mixed even for identity hashes
+            const auto hashed = static_cast<std::uint64_t>(std::hash<value_type>()(value));
+            const int bits = std::countr_zero(slots);
+            return static_cast<std::size_t>((hashed * 0x9e3779b97f4a7c15ULL) >> (64 - bits));
+        }
+
+        [[nodiscard]] constexpr _Node* _cached(const_reference value) const noexcept {
+            if constexpr (hashable<value_type>) {
+                if (!this->hot.empty()) {
+                    _Node* node = this->hot[_slot_of(value, this->hot.size())];
+                    if (node != nullptr && !(value < node->value) && !(node->value < value)) {
+                        return node;
+                    }
+                }
+            }
+
+            return nullptr;
+        }
+
+        constexpr void _remember(_Node* node) const noexcept {
+            if constexpr (hashable<value_type>) {
+                if (!this->hot.empty()) {
+                    this->hot[_slot_of(node->value, this->hot.size())] = node;
+                }
+            }
+        }
+
+        constexpr void _forget(_Node* node) noexcept {
+            if constexpr (hashable<value_type>) {
+                if (!this->hot.empty()) {
+                    _Node*& slot = this->hot[_slot_of(node->value, this->hot.size())];
+                    if (slot == node) {
+                        slot = nullptr;
+                    }
+                }
+            }
+        }
+
+        constexpr void _index_insert(_Node* node) {
+            if constexpr (hashable<value_type>) {
+                if (this->index.empty()) {
+                    return;
+                }
+
+                if (2 * (this->indexed + 1) > this->index.size()) {
+                    // Rehash from the old table rather than the tree, which may be half-built at this point
+                    std::vector<_Node*, _SlotAllocator> old(2 * this->index.size(),
+                                                            nullptr,
+                                                            this->index.get_allocator());
+                    old.swap(this->index);
+                    for (_Node* entry : old) {
+                        if (entry != nullptr) {
+                            this->_index_place(entry);
+                        }
+                    }
+                }
+
+                this->_index_place(node);
+                ++this->indexed;
+            }
+        }
+
+        constexpr void _index_place(_Node* node) noexcept {
+            const std::size_t mask = this->index.size() - 1;
+            std::size_t slot = _slot_of(node->value, this->index.size());
+            while (this->index[slot] != nullptr) {
+                slot = (slot + 1) & mask;
+            }
+
+            this->index[slot] = node;
+        }
+
+        constexpr void _index_erase(_Node* node) noexcept {
+            if constexpr (hashable<value_type>) {
+                if (this->index.empty()) {
+                    return;
+                }
+
+                const std::size_t mask = this->index.size() - 1;
+                std::size_t slot = _slot_of(node->value, this->index.size());
+                while (this->index[slot] != node) {
+                    if (this->index[slot] == nullptr) {
+                        return;
+                    }
+                    slot = (slot + 1) & mask;
+                }
+
+                // Shift later members of the probe run back into the hole, so that lookups never need tombstones
+                std::size_t next = slot;
+                while (true) {
+                    next = (next + 1) & mask;
+                    if (this->index[next] == nullptr) {
+                        break;
+                    }
+
+                    // Move the entry back unless its home slot lies cyclically in (slot, next]
+                    const std::size_t home = _slot_of(this->index[next]->value, this->index.size());
+                    if (((next - home) & mask) >= ((next - slot) & mask)) {
+                        this->index[slot] = this->index[next];
+                        slot = next;
+                    }
+                }
+
+                this->index[slot] = nullptr;
+                --this->indexed;
+            }
+        }
+
+        [[nodiscard]] constexpr _Node* _index_find(const_reference value) const noexcept {
+            const std::size_t mask = this->index.size() - 1;
+            for (std::size_t slot = _slot_of(value, this->index.size()); this->index[slot] != nullptr;
+                 slot = (slot + 1) & mask) {
+                _Node* node = this->index[slot];
+                if (!(value < node->value) && !(node->value < value)) {
+                    return node;
+                }
+            }
+
+            return nullptr;
+        }
+
+        // Rebuilds the index from the tree's nodes, in a table of `slots` entries
+        constexpr void _reindex(std::size_t slots) {
+            this->index.assign(slots, nullptr);
+            this->indexed = 0;
+            for (_Node* node = _leftmost(this->root); node != nullptr; node = _successor(node)) {
+                this->_index_insert(node);
+            }
+        }
+
+        // The child links of `parent` (or the root link, when null) changed: if that link is within the mirrored
+        // levels, or leads to a fringe node, the directory has to be rebuilt
+        constexpr void _reshaped(const _Node* parent) noexcept {
+            if (this->directory.empty() || this->stale) {
+                return;
+            }
+
+            // The depth of the node below the link is the number of nodes from `parent` up to the root
+            std::size_t depth = 0;
+            for (; parent != nullptr; parent = parent->parent) {
+                if (++depth > this->directory_levels) {
+                    return;
+                }
+            }
+
+            this->stale = true;
+        }
+
+        constexpr void _fill_directory(_Node* node, std::size_t position) const {
+            if (position > this->directory.size()) {
+                this->fringe[position - this->directory.size() - 1] = node;
+                return;
+            }
+
+            if (node != nullptr) {
+                this->directory[position - 1] = _Entry{node->value, node};
+                this->_fill_directory(node->left, 2 * position);
+                this->_fill_directory(node->right, 2 * position + 1);
+            }
+        }
+
+        // Walks the directory from `position`; true if it stopped on an equal entry, otherwise `position` is past
+        // the last level, or on an empty entry (the value is absent)
+        constexpr bool _descend_directory(const_reference value, std::size_t& position) const {
+            this->refresh_directory();
+
+            const std::size_t count = this->directory.size();
+            while (position <= count) {
+                const _Entry& entry = this->directory[position - 1];
+                if (entry.node == nullptr) {
+                    return false;
+                }
+
+                if (value < entry.key) {
+                    position = 2 * position;
+                } else if (entry.key < value) {
+                    position = 2 * position + 1;
+                } else {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        [[nodiscard]] constexpr bool _filtered_out(const_reference value) const noexcept {
+            if constexpr (hashable<value_type>) {
+                return this->bloom != nullptr && !this->bloom->may_contain(value);
+            } else {
+                return false;
+            }
+        }
+
+        constexpr void _refilter() noexcept {
+            if constexpr (hashable<value_type>) {
+                if (this->bloom == nullptr) {
+                    return;
+                }
+
+                this->bloom->clear();
+                for (_Node* node = _leftmost(this->root); node != nullptr; node = _successor(node)) {
+                    this->bloom->insert(node->value);
+                }
+            }
+        }
+
+        constexpr void _record(change_kind kind, const_reference value) noexcept {
+            if (this->feed != nullptr) {
+                this->feed->push(kind, value);
+            }
+
+            // Erased values keep their bits: the filter may only answer "absent" for values that really are
+            if constexpr (hashable<value_type>) {
+                if (kind == change_kind::insert && this->bloom != nullptr) {
+                    this->bloom->insert(value);
+                }
+            }
+        }
+
+        // Must be called after the contents have been replaced, since the filter is rebuilt from them
+        constexpr void _record_reset() noexcept {
+            if (this->feed != nullptr) {
+                this->feed->push(change_kind::reset, value_type());
+            }
+
+            std::fill(this->hot.begin(), this->hot.end(), nullptr);
+            this->stale = !this->directory.empty();
+            this->_refilter();
+        }
+
+        [[nodiscard]] constexpr _Node* _build_balanced(std::span<const value_type> values, _Node* parent) {
+            if (values.empty()) {
+                return nullptr;
+            }
+
+            // The middle value becomes the subtree root, so the two halves differ in size by at most one
+            const std::size_t middle = values.size() / 2;
+            _Node* node = this->_construct_node(values[middle]);
+            node->parent = parent;
+            node->left = this->_build_balanced(values.first(middle), node);
+            node->right = this->_build_balanced(values.subspan(middle + 1), node);
+            _refresh(node);
+
+            return node;
+        }
+
+        // Same as `_build_balanced`, but relinks existing nodes (already in order) instead of allocating new ones
+        [[nodiscard]] constexpr _Node* _link_balanced(std::span<_Node* const> nodes, _Node* parent) noexcept {
+            if (nodes.empty()) {
+                return nullptr;
+            }
+
+            const std::size_t middle = nodes.size() / 2;
+            _Node* node = nodes[middle];
+            node->parent = parent;
+            node->left = this->_link_balanced(nodes.first(middle), node);
+            node->right = this->_link_balanced(nodes.subspan(middle + 1), node);
+            _refresh(node);
+
+            return node;
+        }
+
+        // Replaces the contents with `values` (any order, duplicates allowed) in O(n) after sorting. Integral values,
+        // and values with a `radix_traits` key, are sorted with the parallel radix sort instead of comparisons.
+        constexpr void _assign_unsorted(std::vector<value_type>& values) {
+            if constexpr (radix_sortable<value_type>) {
+                radix_sort(std::span<value_type>(values));
+            } else {
+                std::sort(values.begin(), values.end());
+            }
+            values.erase(std::unique(values.begin(), values.end(), [](const_reference lhs, const_reference rhs) {
+                return !(lhs < rhs) && !(rhs < lhs);
+            }), values.end());
+
+            this->_destroy_subtree(this->root);
+            this->root = this->_build_balanced(values, nullptr);
+            this->sz = values.size();
+            this->_record_reset();
+        }
+
+        constexpr void _steal(binary_tree& other) noexcept {
+            this->root = other.root;
+            this->sz = other.sz;
+
+            other.root = nullptr;
+            other.sz = 0;
+
+            // The index describes exactly these nodes, so it moves with them and `other` is left with ours, now empty
+            using std::swap;
+            swap(this->index, other.index);
+            swap(this->indexed, other.indexed);
+
+            // The nodes moved, so `other` must not find them through its cache or directory any more
+            std::fill(other.hot.begin(), other.hot.end(), nullptr);
+            this->stale = !this->directory.empty();
+            other.stale = !other.directory.empty();
+        }
+
+        [[nodiscard]] static constexpr _Node* _leftmost(_Node* node) noexcept {
+            if (node == nullptr) {
+                return nullptr;
+            }
+
+            while (node->left != nullptr) {
+                node = node->left;
+            }
+
+            return node;
+        }
+
+        [[nodiscard]] static constexpr _Node* _rightmost(_Node* node) noexcept {
+            if (node == nullptr) {
+                return nullptr;
+            }
+
+            while (node->right != nullptr) {
+                node = node->right;
+            }
+
+            return node;
+        }
+
+        [[nodiscard]] static constexpr _Node* _successor(_Node* node) noexcept {
+            // If the node has a right subtree, its successor is the smallest node in it
+            if (node->right != nullptr) {
+                return _leftmost(node->right);
+            }
+
+            // Otherwise, climb until we leave a left subtree
+            _Node* parent = node->parent;
+            while (parent != nullptr && node == parent->right) {
+                node = parent;
+                parent = parent->parent;
+            }
 
             return parent;
         }
+
+        [[nodiscard]] static constexpr _Node* _predecessor(_Node* node) noexcept {
+            // If the node has a left subtree, its predecessor is the largest node in it
+            if (node->left != nullptr) {
+                return _rightmost(node->left);
+            }
+
+            // Otherwise, climb until we leave a right subtree
+            _Node* parent = node->parent;
+            while (parent != nullptr && node == parent->left) {
+                node = parent;
+                parent = parent->parent;
+            }
+
+            return parent;
+        }
+
+        // `node` if it is live, else the next live node after it
+        template<class Node>
+        [[nodiscard]] static constexpr Node* _live(Node* node) noexcept {
+            if constexpr (_tombstones) {
+                while (node != nullptr && _dead(node)) {
+                    node = _successor(const_cast<_Node*>(node));
+                }
+            }
+
+            return node;
+        }
+
+        // `node` if it is live, else the last live node before it
+        [[nodiscard]] static constexpr _Node* _live_back(_Node* node) noexcept {
+            if constexpr (_tombstones) {
+                while (node != nullptr && _dead(node)) {
+                    node = _predecessor(node);
+                }
+            }
+
+            return node;
+        }
+
+        [[nodiscard]] static constexpr _Node* _next(_Node* node) noexcept { return _live(_successor(node)); }
+
+        [[nodiscard]] static constexpr _Node* _prev(_Node* node) noexcept { return _live_back(_predecessor(node)); }
+
+        [[nodiscard]] constexpr std::uint64_t _prefix_digest(const_reference bound, bool inclusive) const noexcept
+            requires requires(const augment_type& augment) { augment.digest; } {
+            // Sum the digests of every value `< bound` (or `<= bound` when `inclusive`) along one root-to-leaf path
+            std::uint64_t digest = 0;
+            const _Node* node = this->root;
+            while (node != nullptr) {
+                if (inclusive ? bound < node->value : !(node->value < bound)) {
+                    node = node->left;
+                } else {
+                    if (node->left != nullptr) {
+                        digest += node->left->augment.digest;
+                    }
+                    digest += augment_type::mix(node->value);
+                    node = node->right;
+                }
+            }
+
+            return digest;
+        }
+
+        [[nodiscard]] constexpr std::uint64_t _range_digest(const value_type* low, const value_type* high) const noexcept
+            requires requires(const augment_type& augment) { augment.digest; } {
+            // Digest of every value strictly between `low` and `high`, where null means unbounded
+            const std::uint64_t upper = high != nullptr ? this->_prefix_digest(*high, false)
+                                                        : (this->root != nullptr ? this->root->augment.digest : 0);
+            const std::uint64_t lower = low != nullptr ? this->_prefix_digest(*low, true) : 0;
+
+            return upper - lower;
+        }
+
+        template<class Visitor>
+        constexpr void _diff(const _Node* node,
+                             const binary_tree& other,
+                             const value_type* low,
+                             const value_type* high,
+                             Visitor& visitor) const {
+            const std::uint64_t mine = node != nullptr ? node->augment.digest : 0;
+            if (mine == other._range_digest(low, high)) {
+                // Both sides hold the same values in this key range
+                return;
+            }
+
+            if (node == nullptr) {
+                // Everything `other` holds in this range is missing here
+                const _Node* theirs = low != nullptr ? other._lower_bound_node(*low, true) : _live(_leftmost(other.root));
+                while (theirs != nullptr && (high == nullptr || theirs->value < *high)) {
+                    visitor(theirs->value, false);
+                    theirs = _next(const_cast<_Node*>(theirs));
+                }
+                return;
+            }
+
+            this->_diff(node->left, other, low, &node->value, visitor);
+
+            if (!_dead(node) && other._find_node(node->value) == nullptr) {
+                visitor(node->value, true);
+            }
+
+            this->_diff(node->right, other, &node->value, high, visitor);
+        }
+
+        template<class Visitor>
+        static constexpr void _find_batch(const _Node* node, std::span<const value_type> keys, Visitor& visitor) {
+            while (!keys.empty()) {
+                if (node == nullptr) {
+                    for (const_reference key : keys) {
+                        visitor(key, const_iterator(nullptr));
+                    }
+                    return;
+                }
+
+                // Split the keys around this node: the smaller ones continue left, the larger ones right, so every
+                // node on a path shared by several keys is visited once
+                const auto less = std::lower_bound(keys.begin(), keys.end(), node->value);
+                const auto greater = std::upper_bound(less, keys.end(), node->value);
+                const auto middle = static_cast<std::size_t>(less - keys.begin());
+                const auto equal = static_cast<std::size_t>(greater - less);
+
+                if (equal + middle < keys.size()) {
+                    _prefetch(node->right);
+                }
+
+                _find_batch(node->left, keys.first(middle), visitor);
+
+                for (const_reference key : keys.subspan(middle, equal)) {
+                    visitor(key, const_iterator(_dead(node) ? nullptr : node));
+                }
+
+                // The larger keys continue right without recursing, so only left turns use the stack
+                keys = keys.subspan(middle + equal);
+                node = node->right;
+            }
+        }
+
+        static constexpr void _prefetch(const _Node* node) noexcept {
+            if !consteval {
+                if (node != nullptr) {
+                    __builtin_prefetch(node);
+                }
+            }
+        }
+
     public:
         /* --------------------------------------------Constant Iterator-------------------------------------------- */
         class const_iterator {
@@ -621,27 +1526,178 @@ namespace adt {
 
         };
 
+    protected:
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // The iterators' node constructors are only visible to `binary_tree`, so engines build iterators through these
+        [[nodiscard]] static constexpr iterator _iterator_at(_Node* node) noexcept { return iterator(node); }
+
+        [[nodiscard]] static constexpr const_iterator _const_iterator_at(const _Node* node) noexcept {
+            return const_iterator(node);
+        }
+
+        [[nodiscard]] static constexpr _Node* _node_of(const_iterator position) noexcept {
+            return const_cast<_Node*>(position.node);
+        }
+
+    public:
         /* ----------------------------------------------Constructors----------------------------------------------- */
         constexpr binary_tree() noexcept : root(nullptr), sz(0) {}
 
         constexpr explicit binary_tree(const allocator_type& allocator) noexcept 
-            : root(nullptr), allocator(allocator), sz(0) {}
+            : root(nullptr), allocator(allocator), node_allocator(allocator), sz(0) {}
+
+        constexpr binary_tree(const binary_tree& other)
+            : root(nullptr),
+              allocator(allocator_traits::select_on_container_copy_construction(other.allocator)),
+              node_allocator(this->allocator),
+              sz(0) {
+            this->root = this->_clone_subtree(other.root);
+            this->sz = other.sz;
+        }
 
-        constexpr binary_tree(const binary_tree&) noexcept = default;
+        constexpr binary_tree(const binary_tree& other, const allocator_type& allocator)
+            : root(nullptr), allocator(allocator), node_allocator(allocator), sz(0) {
+            this->root = this->_clone_subtree(other.root);
+            this->sz = other.sz;
+        }
         
-        constexpr binary_tree(binary_tree&&) noexcept = default;
+        constexpr binary_tree(binary_tree&& other) noexcept
+            : root(nullptr),
+              allocator(std::move(other.allocator)),
+              node_allocator(std::move(other.node_allocator)),
+              sz(0) {
+            this->_steal(other);
+        }
+
+        constexpr binary_tree(binary_tree&& other, const allocator_type& allocator)
+            : root(nullptr), allocator(allocator), node_allocator(allocator), sz(0) {
+            if (this->allocator == other.allocator) {
+                this->_steal(other);
+                return;
+            }
+
+            // The nodes belong to a different resource, so they have to be copied into ours
+            this->root = this->_clone_subtree(other.root);
+            this->sz = other.sz;
+        }
 
         /* -----------------------------------------------Destructor------------------------------------------------ */
-        constexpr virtual ~binary_tree() noexcept = default;
+        constexpr virtual ~binary_tree() noexcept { this->_destroy_subtree(this->root); }
 
         /* ------------------------------------------Overloaded Operators------------------------------------------- */
-        constexpr binary_tree& operator=(const binary_tree&) noexcept = default;
+        constexpr binary_tree& operator=(const binary_tree& other) {
+            if (this == &other) {
+                return *this;
+            }
+
+            this->_destroy_subtree(this->root);
+            this->root = nullptr;
+            this->sz = 0;
+
+            if constexpr (allocator_traits::propagate_on_container_copy_assignment::value) {
+                this->allocator = other.allocator;
+                this->node_allocator = _NodeAllocator(this->allocator);
+            }
+
+            this->root = this->_clone_subtree(other.root);
+            this->sz = other.sz;
+            this->_record_reset();
+
+            return *this;
+        }
+
+        constexpr binary_tree& operator=(binary_tree&& other)
+            noexcept(allocator_traits::propagate_on_container_move_assignment::value ||
+                     allocator_traits::is_always_equal::value) {
+            if (this == &other) {
+                return *this;
+            }
+
+            this->_destroy_subtree(this->root);
+            this->root = nullptr;
+            this->sz = 0;
+
+            bool stolen = true;
+            if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+                // Take over the allocator along with the nodes it owns
+                this->allocator = std::move(other.allocator);
+                this->node_allocator = std::move(other.node_allocator);
+                this->_steal(other);
+            } else if (this->allocator == other.allocator) {
+                this->_steal(other);
+            } else {
+                // The allocators differ and may not propagate, so copy the nodes into our own allocator
+                this->root = this->_clone_subtree(other.root);
+                this->sz = other.sz;
+                stolen = false;
+            }
+
+            // The trees change wholesale, so their feeds cannot describe it record by record; a copied source is
+            // left as it was
+            this->_record_reset();
+            if (stolen) {
+                other._record_reset();
+            }
+
+            return *this;
+        }
+
+        [[nodiscard]] constexpr bool operator==(const binary_tree& other) const noexcept {
+            // Trees of different sizes can never hold the same values
+            if (this->sz != other.sz) {
+                return false;
+            }
+
+            if (this->root == other.root) {
+                return true;
+            }
+
+            // With digests available, unequal trees are almost always rejected without walking them
+            if constexpr (requires(const augment_type& augment) { augment.digest; }) {
+                if (this->root->augment.digest != other.root->augment.digest) {
+                    return false;
+                }
+            }
 
-        constexpr binary_tree& operator=(binary_tree&&) noexcept = default;
+            // Walk both trees in order, in lockstep, stopping at the first mismatch
+            _Node* lhs = _live(_leftmost(this->root));
+            _Node* rhs = _live(_leftmost(other.root));
+            while (lhs != nullptr && rhs != nullptr) {
+                // Start pulling in the right subtrees while the current values are compared,
+                // since that is where both successors are usually found
+                _prefetch(lhs->right);
+                _prefetch(rhs->right);
+
+                if (!(lhs->value == rhs->value)) {
+                    return false;
+                }
+
+                lhs = _next(lhs);
+                rhs = _next(rhs);
+            }
+
+            return lhs == rhs;
+        }
+
+        [[nodiscard]] constexpr std::compare_three_way_result_t<value_type>
+        operator<=>(const binary_tree& other) const noexcept requires std::three_way_comparable<value_type> {
+            // Compare lexicographically, as the standard containers do
+            _Node* lhs = _live(_leftmost(this->root));
+            _Node* rhs = _live(_leftmost(other.root));
+            while (lhs != nullptr && rhs != nullptr) {
+                _prefetch(lhs->right);
+                _prefetch(rhs->right);
+
+                if (auto order = lhs->value <=> rhs->value; order != 0) {
+                    return order;
+                }
 
-        [[nodiscard]] constexpr bool operator==(const binary_tree&) const noexcept = default;
+                lhs = _next(lhs);
+                rhs = _next(rhs);
+            }
 
-        [[nodiscard]] constexpr auto operator<=>(const binary_tree&) const noexcept = default;
+            return this->sz <=> other.sz;
+        }
 
         /* ------------------------------------------------Methods-------------------------------------------------- */
         [[nodiscard]] constexpr size_type size() const noexcept { return this->sz; }
@@ -652,6 +1708,244 @@ namespace adt {
 
         [[nodiscard]] constexpr bool empty() const noexcept { return this->sz == 0; }
 
+        [[nodiscard]] constexpr allocator_type get_allocator() const noexcept { return this->allocator; }
+
+        [[nodiscard]] constexpr iterator begin() noexcept { return iterator(_live(_leftmost(this->root))); }
+
+        [[nodiscard]] constexpr const_iterator begin() const noexcept {
+            return const_iterator(_live(_leftmost(this->root)));
+        }
+
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return this->begin(); }
+
+        [[nodiscard]] constexpr iterator end() noexcept { return iterator(nullptr); }
+
+        [[nodiscard]] constexpr const_iterator end() const noexcept { return const_iterator(nullptr); }
+
+        [[nodiscard]] constexpr const_iterator cend() const noexcept { return this->end(); }
+
+        [[nodiscard]] constexpr reverse_iterator rbegin() noexcept {
+            return reverse_iterator(_live_back(_rightmost(this->root)));
+        }
+
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(_live_back(_rightmost(this->root)));
+        }
+
+        [[nodiscard]] constexpr const_reverse_iterator crbegin() const noexcept { return this->rbegin(); }
+
+        [[nodiscard]] constexpr reverse_iterator rend() noexcept { return reverse_iterator(nullptr); }
+
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(nullptr); }
+
+        [[nodiscard]] constexpr const_reverse_iterator crend() const noexcept { return this->rend(); }
+
+        constexpr void swap(binary_tree& other) noexcept {
+            using std::swap;
+
+            // Per the allocator-aware container requirements, swapping trees with unequal,
+            // non-propagating allocators is undefined, so only the allocators that propagate are swapped
+            if constexpr (allocator_traits::propagate_on_container_swap::value) {
+                swap(this->allocator, other.allocator);
+                swap(this->node_allocator, other.node_allocator);
+            }
+
+            swap(this->root, other.root);
+            swap(this->sz, other.sz);
+            swap(this->index, other.index);
+            swap(this->indexed, other.indexed);
+
+            this->_record_reset();
+            other._record_reset();
+        }
+
+        friend constexpr void swap(binary_tree& lhs, binary_tree& rhs) noexcept { lhs.swap(rhs); }
+
+        // Engines report every insertion and erasure to `feed`, from the mutating thread, until it is detached with
+        // `observe(nullptr)`. Bulk replacement (assignment, swap) is reported as a single `change_kind::reset`.
+        constexpr void observe(change_feed<value_type>* feed) noexcept { this->feed = feed; }
+
+        [[nodiscard]] constexpr change_feed<value_type>* observer() const noexcept { return this->feed; }
+
+        // Puts `filter` in front of lookups, so that most absent values are rejected without descending the tree. The
+        // filter is rebuilt from the current contents now and after every bulk replacement, and kept up to date by
+        // the engines on insertion; erasures leave stale bits behind, so rebuild it with `filter_with(filter())` once
+        // many values have been erased. Detach it with `filter_with(nullptr)`.
+        constexpr void filter_with(bloom_filter<value_type>* filter) noexcept
+            requires hashable<value_type> {
+            this->bloom = filter;
+            this->_refilter();
+        }
+
+        [[nodiscard]] constexpr bloom_filter<value_type>* filter() const noexcept { return this->bloom; }
+
+        // Keeps the last node found for each of `slots` (rounded up to a power of two) hash buckets, so repeated
+        // lookups of hot values skip the descent. Freed nodes are dropped from the cache as they go. Lookups write to
+        // the cache, so a tree with a cache must not be searched from several threads at once. Zero disables it.
+        constexpr void cache_lookups(size_type slots) requires hashable<value_type> {
+            this->hot.assign(slots != 0 ? std::bit_ceil(std::max<size_type>(slots, 2)) : 0, nullptr);
+        }
+
+        [[nodiscard]] constexpr size_type lookup_cache_slots() const noexcept { return this->hot.size(); }
+
+        // Mirrors the top `levels` levels of the tree into a contiguous Eytzinger array of values and node pointers,
+        // so lookups descend those levels in a few cache lines instead of one scattered node each. Changes below the
+        // mirrored levels leave it alone; changes within them mark it stale, and the next lookup rebuilds it in
+        // O(2^levels). Like the lookup cache, this makes lookups write. Zero disables it.
+        constexpr void index_top_levels(size_type levels) requires std::default_initializable<value_type> {
+            this->directory_levels = levels;
+            this->directory.assign(levels != 0 ? (size_type(1) << levels) - 1 : 0, _Entry{value_type(), nullptr});
+            this->fringe.assign(levels != 0 ? size_type(1) << levels : 0, nullptr);
+            this->stale = levels != 0;
+        }
+
+        [[nodiscard]] constexpr size_type indexed_levels() const noexcept { return this->directory_levels; }
+
+        // Rebuilds a stale directory now rather than on the next lookup; until the tree is next changed, lookups
+        // then only read it
+        constexpr void refresh_directory() const requires std::default_initializable<value_type> {
+            if (!this->stale) {
+                return;
+            }
+
+            std::fill(this->directory.begin(), this->directory.end(), _Entry{value_type(), nullptr});
+            std::fill(this->fringe.begin(), this->fringe.end(), nullptr);
+            this->_fill_directory(this->root, 1);
+            this->stale = false;
+        }
+
+        // Keeps a hash table of every node next to the tree, so that point lookups (`contains`, `find`, `erase` by
+        // value) take O(1) expected time instead of a descent, at the price of one pointer slot per node (at load
+        // factor one half, two). The table is updated wherever nodes are created or freed, and moves with the nodes.
+        constexpr void index_points(bool enable) requires hashable<value_type> {
+            if (!enable) {
+                std::vector<_Node*, _SlotAllocator>(this->index.get_allocator()).swap(this->index);
+                this->indexed = 0;
+                return;
+            }
+
+            this->_reindex(std::bit_ceil(std::max<size_type>(2 * this->sz, 16)));
+        }
+
+        [[nodiscard]] constexpr bool points_indexed() const noexcept { return !this->index.empty(); }
+
+        // Calls `visitor(value, in_this)` in ascending order for every value held by exactly one of `*this` and
+        // `other`. Only key ranges whose digests differ are descended into, so the cost grows with the number of
+        // differences rather than with the size of the trees.
+        template<class Visitor>
+        constexpr void diff(const binary_tree& other, Visitor visitor) const
+            requires requires(const augment_type& augment) { augment.digest; } {
+            this->_diff(this->root, other, nullptr, nullptr, visitor);
+        }
+
+        // Moves every value of `sources` into this tree and leaves them empty. The in-order streams of all the trees
+        // (this one included) are merged through a heap and the result is linked as a perfectly balanced tree in
+        // O(n log k). Nodes are reused rather than reallocated whenever the source's allocator equals ours.
+        constexpr void absorb(std::span<binary_tree* const> sources) {
+            using cursor = std::pair<_Node*, std::size_t>;
+
+            std::vector<binary_tree*> trees{this};
+            for (binary_tree* source : sources) {
+                if (source != this && source->root != nullptr) {
+                    trees.push_back(source);
+                }
+            }
+
+            const auto later = [](const cursor& lhs, const cursor& rhs) { return rhs.first->value < lhs.first->value; };
+            std::priority_queue<cursor, std::vector<cursor>, decltype(later)> heap(later);
+
+            std::size_t total = 0;
+            for (std::size_t i = 0; i < trees.size(); ++i) {
+                if (trees[i]->root != nullptr) {
+                    heap.emplace(_leftmost(trees[i]->root), i);
+                    total += trees[i]->sz;
+                }
+            }
+
+            std::vector<_Node*> nodes;
+            std::vector<_Node*> copies;
+            std::vector<_Node*> duplicates;
+            nodes.reserve(total);
+            copies.reserve(total);
+
+            // Nothing is relinked or freed until every stream is exhausted, since the walks follow the old links.
+            // Tombstoned nodes are dropped like duplicates.
+            try {
+                while (!heap.empty()) {
+                    const auto [node, index] = heap.top();
+                    heap.pop();
+
+                    if (_Node* next = _successor(node); next != nullptr) {
+                        heap.emplace(next, index);
+                    }
+
+                    const bool stolen = trees[index]->node_allocator == this->node_allocator;
+                    if (_dead(node) || (!nodes.empty() && !(nodes.back()->value < node->value))) {
+                        if (stolen) {
+                            duplicates.push_back(node);
+                        }
+                    } else if (stolen) {
+                        nodes.push_back(node);
+                    } else {
+                        // Both vectors have room for every value, so the copy is recorded before anything can throw
+                        copies.push_back(this->_construct_node(node->value));
+                        nodes.push_back(copies.back());
+                    }
+                }
+            } catch (...) {
+                // Every tree is still linked as it was, so only the copies made so far have to go
+                for (_Node* copy : copies) {
+                    this->_free_node(copy);
+                }
+                throw;
+            }
+
+            for (_Node* duplicate : duplicates) {
+                this->_free_node(duplicate);
+            }
+
+            for (binary_tree* tree : trees) {
+                // Copied sources still own their nodes; stolen ones were relinked or freed above
+                if (tree->node_allocator != this->node_allocator) {
+                    tree->_destroy_subtree(tree->root);
+                }
+
+                std::fill(tree->hot.begin(), tree->hot.end(), nullptr);
+                tree->stale = !tree->directory.empty();
+                tree->root = nullptr;
+                tree->sz = 0;
+            }
+
+            this->root = this->_link_balanced(nodes, nullptr);
+            this->sz = nodes.size();
+
+            // Reused nodes never went through `_construct_node`, so index them (and forget the sources') wholesale
+            for (binary_tree* tree : trees) {
+                if (!tree->index.empty()) {
+                    tree->_reindex(tree->index.size());
+                }
+            }
+
+            for (binary_tree* tree : trees) {
+                tree->_record_reset();
+            }
+        }
+
+        // Returns the first position at or after `from` whose value is `>= value`, in O(log d) for a result d steps
+        // ahead of `from`, rather than the O(log n) of a search from the root
+        [[nodiscard]] constexpr const_iterator seek(const_iterator from, const_reference value) const noexcept {
+            return const_iterator(_seek_node(from.node, value));
+        }
+
+        // Looks up every key of `keys`, which must be sorted, and calls `visitor(key, position)` for each in order,
+        // where `position` is `end()` for absent keys. The batch is split at each node and the halves continue down
+        // separate subtrees, so paths shared between keys are walked once: O(m log(n / m)) for m keys instead of
+        // O(m log n).
+        template<class Visitor>
+        constexpr void find_sorted_batch(std::span<const value_type> keys, Visitor visitor) const {
+            _find_batch(this->root, keys, visitor);
+        }
+
         constexpr virtual void clear() noexcept = 0;
 
         constexpr virtual void insert(std::initializer_list<value_type>) noexcept = 0;
@@ -660,6 +1954,203 @@ namespace adt {
 
     };
 
+    /* -----------------------------------------------Iterator Methods---------------------------------------------- */
+    // Iterators hold only a node, so stepping past either end yields the null (end) iterator, and stepping an end
+    // iterator is an error, like dereferencing one
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::const_iterator&
+    binary_tree<T, Allocator, Augment>::const_iterator::operator++() {
+        if (this->node == nullptr) {
+            throw std::runtime_error("segmentation fault");
+        }
+        this->node = _next(const_cast<_Node*>(this->node));
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::const_iterator&
+    binary_tree<T, Allocator, Augment>::const_iterator::operator+=(size_type count) {
+        for (; count > 0; --count) {
+            ++(*this);
+        }
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::const_iterator&
+    binary_tree<T, Allocator, Augment>::const_iterator::operator--() {
+        if (this->node == nullptr) {
+            throw std::runtime_error("segmentation fault");
+        }
+        this->node = _prev(const_cast<_Node*>(this->node));
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::const_iterator&
+    binary_tree<T, Allocator, Augment>::const_iterator::operator-=(size_type count) {
+        for (; count > 0; --count) {
+            --(*this);
+        }
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::iterator&
+    binary_tree<T, Allocator, Augment>::iterator::operator++() {
+        if (this->node == nullptr) {
+            throw std::runtime_error("segmentation fault");
+        }
+        this->node = _next(this->node);
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::iterator&
+    binary_tree<T, Allocator, Augment>::iterator::operator+=(size_type count) {
+        for (; count > 0; --count) {
+            ++(*this);
+        }
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::iterator&
+    binary_tree<T, Allocator, Augment>::iterator::operator--() {
+        if (this->node == nullptr) {
+            throw std::runtime_error("segmentation fault");
+        }
+        this->node = _prev(this->node);
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::iterator&
+    binary_tree<T, Allocator, Augment>::iterator::operator-=(size_type count) {
+        for (; count > 0; --count) {
+            --(*this);
+        }
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::const_reverse_iterator&
+    binary_tree<T, Allocator, Augment>::const_reverse_iterator::operator++() {
+        if (this->node == nullptr) {
+            throw std::runtime_error("segmentation fault");
+        }
+        this->node = _prev(const_cast<_Node*>(this->node));
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::const_reverse_iterator&
+    binary_tree<T, Allocator, Augment>::const_reverse_iterator::operator+=(size_type count) {
+        for (; count > 0; --count) {
+            ++(*this);
+        }
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::const_reverse_iterator&
+    binary_tree<T, Allocator, Augment>::const_reverse_iterator::operator--() {
+        if (this->node == nullptr) {
+            throw std::runtime_error("segmentation fault");
+        }
+        this->node = _next(const_cast<_Node*>(this->node));
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::const_reverse_iterator&
+    binary_tree<T, Allocator, Augment>::const_reverse_iterator::operator-=(size_type count) {
+        for (; count > 0; --count) {
+            --(*this);
+        }
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::reverse_iterator&
+    binary_tree<T, Allocator, Augment>::reverse_iterator::operator++() {
+        if (this->node == nullptr) {
+            throw std::runtime_error("segmentation fault");
+        }
+        this->node = _prev(this->node);
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::reverse_iterator&
+    binary_tree<T, Allocator, Augment>::reverse_iterator::operator+=(size_type count) {
+        for (; count > 0; --count) {
+            ++(*this);
+        }
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::reverse_iterator&
+    binary_tree<T, Allocator, Augment>::reverse_iterator::operator--() {
+        if (this->node == nullptr) {
+            throw std::runtime_error("segmentation fault");
+        }
+        this->node = _next(this->node);
+        return *this;
+    }
+
+    template<class T, class Allocator, class Augment>
+    typename binary_tree<T, Allocator, Augment>::reverse_iterator&
+    binary_tree<T, Allocator, Augment>::reverse_iterator::operator-=(size_type count) {
+        for (; count > 0; --count) {
+            --(*this);
+        }
+        return *this;
+    }
+
+    /* --------------------------------------------------Merge All--------------------------------------------------- */
+    // Merges trees of one type into a new balanced tree, leaving them empty. The result uses the first tree's
+    // allocator, so with a shared allocator (or memory resource) every node is reused instead of copied.
+    template<std::ranges::input_range Trees>
+        requires requires(std::ranges::range_value_t<Trees>& tree,
+                          std::span<typename std::ranges::range_value_t<Trees>::binary_tree* const> sources) {
+            tree.absorb(sources);
+        }
+    [[nodiscard]] constexpr std::ranges::range_value_t<Trees> merge_all(Trees&& trees) {
+        using tree_type = std::ranges::range_value_t<Trees>;
+
+        std::vector<typename tree_type::binary_tree*> sources;
+        for (tree_type& tree : trees) {
+            sources.push_back(&tree);
+        }
+
+        if (sources.empty()) {
+            return tree_type();
+        }
+
+        tree_type result(sources.front()->get_allocator());
+        result.absorb(sources);
+        return result;
+    }
+
+    template<class Tree, class... Trees>
+        requires requires(Tree& tree, std::span<typename Tree::binary_tree* const> sources) { tree.absorb(sources); } &&
+                 (std::same_as<Trees, Tree> && ...)
+    [[nodiscard]] constexpr Tree merge_all(Tree& first, Trees&... rest) {
+        Tree result(first.get_allocator());
+        typename Tree::binary_tree* sources[] = {&first, &rest...};
+        result.absorb(sources);
+        return result;
+    }
+
+    namespace pmr {
+
+        template<class T, class Augment = no_augment>
+        using binary_tree = adt::binary_tree<T, std::pmr::polymorphic_allocator<T>, Augment>;
+
+    } // pmr
+
 } // adt
 
 
@@ -1,10 +1,1389 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <array>
+#include <memory_resource>
+#include <vector>
+#include <string>
+#include <random>
+#include <set>
+#include <map>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <limits>
+#include <new>
+
 #include "binary_tree.hpp"
+#include "critbit_tree.hpp"
+#include "art_set.hpp"
+#include "veb_set.hpp"
+#include "avl_tree.hpp"
+#include "adaptive_set.hpp"
+#include "string_key.hpp"
+#include "string_tree.hpp"
+#include "bloom_filter.hpp"
+#include "radix_sort.hpp"
+#include "tree_views.hpp"
+#include "logarithmic_set.hpp"
+#include "optimal_tree.hpp"
+#include "indexed_tree.hpp"
+#include "tiered_tree.hpp"
+#include "lazy_tree.hpp"
+#include "relaxed_tree.hpp"
+#include "combining_tree.hpp"
+#include "swappable_index.hpp"
+#include "mvcc_tree.hpp"
+
+
+// Minimal unbalanced engine used to exercise the behaviour implemented by the abstract base
+template<class T, class Allocator = std::allocator<T>, class Augment = adt::no_augment>
+class probe_tree : public adt::binary_tree<T, Allocator, Augment> {
+private:
+	using base = adt::binary_tree<T, Allocator, Augment>;
+
+	using typename base::_Node;
+
+public:
+	using base::base;
+
+	void clear() noexcept override {
+		this->_destroy_subtree(this->root);
+		this->root = nullptr;
+		this->sz = 0;
+		this->_record_reset();
+	}
+
+	void insert(std::initializer_list<T> values) noexcept override {
+		for (const T& value : values) {
+			if (this->root == nullptr) {
+				this->root = this->_construct_node(value);
+				++this->sz;
+				this->_record(adt::change_kind::insert, value);
+				continue;
+			}
+
+			_Node* parent = this->root;
+			while (true) {
+				if (value == parent->value) {
+					break;
+				}
+
+				_Node* next = value < parent->value ? parent->left : parent->right;
+				if (next == nullptr) {
+					this->_construct_node(value, parent, nullptr, nullptr);
+					++this->sz;
+					this->_record(adt::change_kind::insert, value);
+					break;
+				}
+				parent = next;
+			}
+		}
+	}
+
+	[[nodiscard]] bool contains(const T& value) const noexcept override {
+		const _Node* node = this->root;
+		while (node != nullptr && node->value != value) {
+			node = value < node->value ? node->left : node->right;
+		}
+		return node != nullptr;
+	}
+
+	void rotate_root_left() noexcept { this->_rotate_left(this->root); }
+
+};
+
+// Memory resource that counts the bytes it has handed out and fails once `budget` allocations have been made
+class counting_resource : public std::pmr::memory_resource {
+public:
+	std::ptrdiff_t live = 0;
+
+	std::size_t budget = std::numeric_limits<std::size_t>::max();
+
+private:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+		if (this->budget == 0) {
+			throw std::bad_alloc();
+		}
+		--this->budget;
+		this->live += static_cast<std::ptrdiff_t>(bytes);
+		return ::operator new(bytes, std::align_val_t(alignment));
+	}
+
+	void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {
+		this->live -= static_cast<std::ptrdiff_t>(bytes);
+		::operator delete(pointer, bytes, std::align_val_t(alignment));
+	}
+
+	[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+
+};
 
 
 TEST(binary_tree, dummy_test) {
 	EXPECT_THAT(0, testing::Eq(0));
 }
 
+TEST(binary_tree, move_leaves_source_empty) {
+	probe_tree<int> source;
+	source.insert({5, 3, 8, 1, 4});
+
+	probe_tree<int> target(std::move(source));
+	EXPECT_THAT(target.size(), testing::Eq(5));
+	EXPECT_TRUE(target.contains(4));
+	EXPECT_TRUE(source.empty());
+	EXPECT_FALSE(source.contains(4));
+
+	source.insert({42});
+	swap(source, target);
+	EXPECT_THAT(source.size(), testing::Eq(5));
+	EXPECT_TRUE(target.contains(42));
+}
+
+TEST(binary_tree, pmr_move_across_resources_copies) {
+	std::array<std::byte, 4096> buffer;
+	std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+
+	probe_tree<int, std::pmr::polymorphic_allocator<int>> source(&arena);
+	source.insert({2, 1, 3});
+
+	// The nodes are copied, so the source is left untouched and its feed hears nothing
+	adt::change_feed<int> feed(4);
+	source.observe(&feed);
+
+	probe_tree<int, std::pmr::polymorphic_allocator<int>> target;
+	target = std::move(source);
+	EXPECT_THAT(target.get_allocator().resource(), testing::Eq(std::pmr::get_default_resource()));
+	EXPECT_TRUE(target.contains(1) && target.contains(2) && target.contains(3));
+	EXPECT_THAT(feed.drain([](const adt::change_record<int>&) {}), testing::Eq(0));
+	source.observe(nullptr);
+
+	probe_tree<int, std::pmr::polymorphic_allocator<int>> copy(target);
+	EXPECT_THAT(copy.size(), testing::Eq(3));
+}
+
+TEST(binary_tree, pmr_accelerators_use_the_tree_resource) {
+	std::vector<std::byte> buffer(1 << 20);
+	std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+	// Anything allocated from the default resource would throw
+	std::pmr::memory_resource* const previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+	{
+		adt::pmr::avl_tree<int> tree(&arena);
+		tree.index_points(true);
+		tree.cache_lookups(64);
+		tree.index_top_levels(3);
+		for (int i = 0; i < 1000; ++i) {
+			tree.insert(i);
+		}
+		EXPECT_TRUE(tree.contains(500));
+		tree.index_points(false);
+		EXPECT_TRUE(tree.contains(999));
+	}
+	std::pmr::set_default_resource(previous);
+}
+
+TEST(binary_tree, failed_copies_free_their_partial_clones) {
+	counting_resource source_resource;
+	counting_resource target_resource;
+	adt::pmr::avl_tree<int> source(&source_resource);
+	for (int i = 0; i < 100; ++i) {
+		source.insert(i);
+	}
+
+	adt::pmr::avl_tree<int> target({1000}, &target_resource);
+	target_resource.budget = 50;
+	EXPECT_THROW(target = source, std::bad_alloc);
+	EXPECT_THAT(target_resource.live, testing::Eq(0));
+	EXPECT_TRUE(target.empty());
+
+	target_resource.budget = 50;
+	EXPECT_THROW(target = std::move(source), std::bad_alloc);
+	EXPECT_THAT(target_resource.live, testing::Eq(0));
+	EXPECT_THAT(source.size(), testing::Eq(100));
+
+	target_resource.budget = std::numeric_limits<std::size_t>::max();
+	target = source;
+	EXPECT_TRUE(target == source);
+}
+
+TEST(binary_tree, equality_compares_contents) {
+	probe_tree<int> lhs;
+	probe_tree<int> rhs;
+	lhs.insert({1, 2, 3, 4});
+	rhs.insert({3, 1, 4, 2});
+	EXPECT_TRUE(lhs == rhs);
+
+	rhs.insert({5});
+	EXPECT_FALSE(lhs == rhs);
+	EXPECT_TRUE(lhs < rhs);
+
+	lhs.insert({6});
+	EXPECT_TRUE(lhs > rhs);
+}
+
+TEST(binary_tree, merkle_diff_reports_only_differences) {
+	using merkle_tree = probe_tree<int, std::allocator<int>, adt::merkle_digest<int>>;
+
+	merkle_tree lhs;
+	merkle_tree rhs;
+	lhs.insert({50, 20, 80, 10, 30, 70, 90, 60});
+	rhs.insert({10, 20, 30, 50, 60, 70, 80, 90});
+	EXPECT_TRUE(lhs == rhs);
+
+	lhs.insert({25});
+	rhs.insert({95, 5});
+	lhs.rotate_root_left();
+
+	std::vector<std::pair<int, bool>> differences;
+	lhs.diff(rhs, [&](int value, bool in_lhs) { differences.emplace_back(value, in_lhs); });
+	EXPECT_THAT(differences, testing::ElementsAre(std::pair(5, false), std::pair(25, true), std::pair(95, false)));
+}
+
+TEST(binary_tree, change_feed_records_mutations_in_order) {
+	adt::change_feed<int> feed(4);
+	probe_tree<int> tree;
+	tree.observe(&feed);
+	tree.insert({3, 1, 3, 2});
+
+	std::vector<int> inserted;
+	feed.drain([&](const adt::change_record<int>& record) {
+		EXPECT_THAT(record.kind, testing::Eq(adt::change_kind::insert));
+		inserted.push_back(record.value);
+	});
+	EXPECT_THAT(inserted, testing::ElementsAre(3, 1, 2));
+
+	tree.insert({4, 5, 6, 7, 8});
+	EXPECT_TRUE(feed.overflowed());
+	EXPECT_THAT(feed.drain([](const adt::change_record<int>&) {}, 2), testing::Eq(2));
+	EXPECT_THAT(feed.drain([](const adt::change_record<int>&) {}), testing::Eq(2));
+}
+
+TEST(binary_tree, string_keys_compare_on_prefix_then_bytes) {
+	adt::string_arena arena(16);
+	probe_tree<adt::string_key> tree;
+	for (std::string_view url : {"https://a.example/x", "https://a.example/y", "https://b", "http", ""}) {
+		const adt::string_key key = arena.intern(url);
+		tree.insert({key});
+	}
+
+	EXPECT_THAT(tree.size(), testing::Eq(5));
+	EXPECT_TRUE(tree.contains(adt::string_key("https://a.example/y")));
+	EXPECT_FALSE(tree.contains(adt::string_key("https://a.example/z")));
+	EXPECT_TRUE(adt::string_key("http") < adt::string_key("https"));
+	EXPECT_TRUE(adt::string_key("https://a.example/x") < adt::string_key("https://a.example/y"));
+}
+
+TEST(string_tree, owns_the_bytes_of_its_keys) {
+	adt::string_tree<> tree;
+	{
+		std::string url = "https://a.example/long/path";
+		EXPECT_TRUE(tree.insert(url).second);
+		url.assign(url.size(), '?');
+		EXPECT_FALSE(tree.insert(std::string_view("https://a.example/long/path")).second);
+	}
+	tree.insert({adt::string_key("https://b")});
+	EXPECT_THAT(tree.keys().bytes_used(), testing::Eq(36));
+	EXPECT_TRUE(tree.contains("https://a.example/long/path"));
+
+	// Copies intern their own keys; moves take the arena along
+	adt::string_tree<> copy = tree;
+	tree.clear();
+	EXPECT_TRUE(copy.contains("https://b"));
+	adt::string_tree<> moved = std::move(copy);
+	EXPECT_THAT(*moved.begin(), testing::Eq(adt::string_key("https://a.example/long/path")));
+
+	std::array<std::byte, 4096> buffer;
+	std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+	adt::pmr::string_tree<> pooled(&arena);
+	pooled.insert(std::string_view("https://c"));
+
+	// Across resources the nodes are copied, and the source gives up the arena they point into
+	adt::pmr::string_tree<> target;
+	target = std::move(pooled);
+	EXPECT_TRUE(target.contains("https://c"));
+	EXPECT_TRUE(pooled.empty());
+	EXPECT_THAT(moved.size(), testing::Eq(2));
+}
+
+TEST(string_tree, swaps_merges_and_moves_keep_keys_with_their_bytes) {
+	adt::string_tree<> a{"https://a/1", "https://a/2"};
+	adt::string_tree<> c{"https://c/1"};
+	a.swap(c);
+	c.clear();
+	EXPECT_THAT(std::vector(a.begin(), a.end()), testing::ElementsAre(adt::string_key("https://c/1")));
+	swap(a, c);
+	a.clear();
+	EXPECT_TRUE(c.contains("https://c/1"));
+
+	adt::string_tree<> b{"https://b/1", "https://shared"};
+	adt::string_tree<> d{"https://d/1", "https://shared"};
+	adt::string_tree<> merged = adt::merge_all(b, d);
+	EXPECT_TRUE(b.empty() && d.empty());
+	EXPECT_THAT(b.keys().bytes_used() + d.keys().bytes_used(), testing::Eq(0));
+	b.insert(std::string_view("https://b/2"));
+	EXPECT_THAT(std::vector(merged.begin(), merged.end()),
+	            testing::ElementsAre(adt::string_key("https://b/1"),
+	                                 adt::string_key("https://d/1"),
+	                                 adt::string_key("https://shared")));
+
+	// An empty source on another resource may still hold arena blocks, which must not change resource
+	counting_resource first;
+	counting_resource second;
+	{
+		adt::pmr::string_tree<> source({"https://e/1"}, &first);
+		source.erase(std::string_view("https://e/1"));
+		adt::pmr::string_tree<> target({"https://f/1"}, &second);
+		target = std::move(source);
+		EXPECT_TRUE(target.empty());
+	}
+	EXPECT_THAT(first.live, testing::Eq(0));
+	EXPECT_THAT(second.live, testing::Eq(0));
+}
+
+TEST(critbit_tree, matches_std_set_on_signed_keys) {
+	adt::critbit_tree<std::int64_t> tree;
+	std::set<std::int64_t> expected;
+	std::mt19937_64 random(7);
+	for (int i = 0; i < 2000; ++i) {
+		const std::int64_t key = static_cast<std::int64_t>(random() % 512) - 256;
+		if (random() % 3 == 0) {
+			EXPECT_THAT(tree.erase(key), testing::Eq(expected.erase(key) == 1));
+		} else {
+			EXPECT_THAT(tree.insert(key), testing::Eq(expected.insert(key).second));
+		}
+	}
+
+	EXPECT_THAT(tree.size(), testing::Eq(expected.size()));
+	EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+	EXPECT_THAT(*std::prev(tree.end()), testing::Eq(*expected.rbegin()));
+}
+
+TEST(critbit_tree, string_prefix_query) {
+	adt::critbit_tree<std::string> tree({"car", "cart", "carbon", "cat", "ca", "dog"});
+
+	std::vector<std::string> matches;
+	tree.for_each_prefix("car", [&](const std::string& key) { matches.push_back(key); });
+	EXPECT_THAT(matches, testing::ElementsAre("car", "carbon", "cart"));
+	EXPECT_TRUE(tree.contains("ca"));
+	EXPECT_FALSE(tree.contains("c"));
+	EXPECT_TRUE(std::is_sorted(tree.begin(), tree.end()));
+}
+
+TEST(critbit_tree, order_walks_see_only_leaves) {
+	const adt::critbit_tree<int> tree{5, 1, 9, 3};
+	EXPECT_THAT(std::vector<int>(tree.rbegin(), tree.rend()), testing::ElementsAre(9, 5, 3, 1));
+
+	const std::array<int, 5> keys{1, 3, 4, 5, 9};
+	std::vector<int> found;
+	tree.find_sorted_batch(keys, [&](int key, auto position) {
+		if (position != tree.end()) {
+			found.push_back(*position);
+		}
+		EXPECT_THAT(position != tree.end(), testing::Eq(key != 4));
+	});
+	EXPECT_THAT(found, testing::ElementsAre(1, 3, 5, 9));
+}
+
+TEST(art_set, matches_std_set_through_node_growth_and_shrinkage) {
+	adt::art_set<std::int32_t> tree;
+	std::set<std::int32_t> expected;
+	std::mt19937 random(11);
+	for (int i = 0; i < 20000; ++i) {
+		// Cluster the keys so that every node size is reached, both growing and shrinking
+		const std::int32_t key = static_cast<std::int32_t>(random() % 4096) - 2048 + (i % 2 == 0 ? 0 : 1 << 20);
+		if (random() % 2 == 0) {
+			EXPECT_THAT(tree.erase(key), testing::Eq(expected.erase(key) == 1));
+		} else {
+			EXPECT_THAT(tree.insert(key), testing::Eq(expected.insert(key).second));
+		}
+	}
+
+	EXPECT_THAT(tree.size(), testing::Eq(expected.size()));
+	EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+	EXPECT_TRUE(tree.contains(*expected.begin()));
+
+	adt::art_set<std::int32_t> copy(tree);
+	EXPECT_TRUE(copy == tree);
+}
+
+TEST(art_set, long_shared_string_prefixes) {
+	adt::art_set<std::string> tree;
+	std::set<std::string> expected;
+	std::mt19937 random(3);
+	for (int i = 0; i < 5000; ++i) {
+		std::string key = "https://example.com/path/";
+		for (int length = static_cast<int>(random() % 4); length >= 0; --length) {
+			key.push_back(static_cast<char>(random() % 3));
+			key.append(random() % 2 == 0 ? "segment/" : "");
+		}
+
+		if (random() % 3 == 0) {
+			EXPECT_THAT(tree.erase(key), testing::Eq(expected.erase(key) == 1));
+		} else {
+			EXPECT_THAT(tree.insert(key), testing::Eq(expected.insert(key).second));
+		}
+		EXPECT_THAT(tree.contains(key), testing::Eq(expected.count(key) == 1));
+	}
+
+	EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+	EXPECT_FALSE(tree.contains("https://example.com/"));
+}
+
+TEST(veb_set, predecessor_and_successor_match_std_set) {
+	adt::veb_set<std::int32_t, 20> tree;
+	std::set<std::int32_t> expected;
+	std::mt19937 random(5);
+	for (int i = 0; i < 20000; ++i) {
+		const std::int32_t key = static_cast<std::int32_t>(random() % 3000) - 1500 + (i % 3 == 0 ? 300000 : 0);
+		if (random() % 3 == 0) {
+			EXPECT_THAT(tree.erase(key), testing::Eq(expected.erase(key) == 1));
+		} else {
+			EXPECT_THAT(tree.insert(key), testing::Eq(expected.insert(key).second));
+		}
+
+		const std::int32_t probe = static_cast<std::int32_t>(random() % 3200) - 1600;
+		const auto after = expected.upper_bound(probe);
+		const auto before = expected.lower_bound(probe);
+		EXPECT_THAT(tree.successor(probe), testing::Eq(after == expected.end() ? std::nullopt : std::optional(*after)));
+		EXPECT_THAT(tree.predecessor(probe),
+		            testing::Eq(before == expected.begin() ? std::nullopt : std::optional(*std::prev(before))));
+	}
+
+	EXPECT_THAT(tree.size(), testing::Eq(expected.size()));
+	EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+	EXPECT_FALSE(tree.insert(1 << 20));
+}
+
+TEST(veb_set, bounds_and_moves_stay_in_the_universe) {
+	adt::veb_set<std::int32_t, 16> tree{5, 10};
+	EXPECT_THAT(tree.successor(65539), testing::Eq(std::nullopt));
+	EXPECT_THAT(tree.successor(-65539), testing::Eq(std::optional(5)));
+	EXPECT_THAT(tree.predecessor(65539), testing::Eq(std::optional(10)));
+	EXPECT_THAT(tree.predecessor(-65539), testing::Eq(std::nullopt));
+	EXPECT_TRUE(tree.lower_bound(65539) == tree.end());
+
+	adt::veb_set<std::int32_t, 16> moved(std::move(tree));
+	EXPECT_FALSE(tree.contains(5));
+	EXPECT_TRUE(tree.insert(7));
+	EXPECT_THAT(tree.min(), testing::Eq(std::optional(7)));
+
+	std::array<std::byte, 1 << 16> buffer;
+	std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+	adt::pmr::veb_set<std::int32_t, 16> pooled(&arena);
+	pooled.insert(3);
+	adt::pmr::veb_set<std::int32_t, 16> target;
+	target = pooled;
+	target = std::move(pooled);
+	EXPECT_THAT(target.get_allocator().resource(), testing::Eq(std::pmr::get_default_resource()));
+	EXPECT_TRUE(target.contains(3));
+	EXPECT_THAT(moved.size(), testing::Eq(2));
+}
+
+TEST(avl_tree, stays_balanced_and_ordered) {
+	adt::avl_tree<int> tree;
+	std::set<int> expected;
+	std::mt19937 random(13);
+	for (int i = 0; i < 20000; ++i) {
+		const int key = static_cast<int>(random() % 5000);
+		if (random() % 3 == 0) {
+			EXPECT_THAT(tree.erase(key), testing::Eq(expected.erase(key)));
+		} else {
+			EXPECT_THAT(tree.insert(key).second, testing::Eq(expected.insert(key).second));
+		}
+	}
+
+	EXPECT_THAT(tree.size(), testing::Eq(expected.size()));
+	EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+	EXPECT_TRUE(std::equal(tree.rbegin(), tree.rend(), expected.rbegin(), expected.rend()));
+	EXPECT_THAT(static_cast<double>(tree.height()), testing::Le(1.44 * std::log2(expected.size() + 2)));
+}
+
+TEST(adaptive_set, switches_layout_with_size_and_density) {
+	adt::adaptive_set<int> values;
+	std::set<int> expected;
+	for (int i = 0; i < 16; ++i) {
+		values.insert(i * 1000);
+		expected.insert(i * 1000);
+	}
+	EXPECT_THAT(values.current_layout(), testing::Eq(adt::adaptive_set<int>::layout::inline_array));
+
+	values.insert(7);
+	expected.insert(7);
+	EXPECT_THAT(values.current_layout(), testing::Eq(adt::adaptive_set<int>::layout::tree));
+
+	for (int i = 0; i < 4096; ++i) {
+		values.insert(i);
+		expected.insert(i);
+	}
+	EXPECT_THAT(values.current_layout(), testing::Eq(adt::adaptive_set<int>::layout::bitset));
+	EXPECT_TRUE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+
+	values.insert(-100000000);
+	expected.insert(-100000000);
+	EXPECT_THAT(values.current_layout(), testing::Eq(adt::adaptive_set<int>::layout::tree));
+	EXPECT_TRUE(values.contains(-100000000) && values.contains(4095) && !values.contains(4096));
+
+	for (const int value : std::vector<int>(expected.begin(), expected.end())) {
+		if (value > 3) {
+			values.erase(value);
+			expected.erase(value);
+		}
+	}
+	EXPECT_THAT(values.current_layout(), testing::Eq(adt::adaptive_set<int>::layout::inline_array));
+	EXPECT_TRUE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+}
+
+TEST(adaptive_set, full_64_bit_span_is_not_dense) {
+	constexpr std::uint64_t top = std::numeric_limits<std::uint64_t>::max();
+	adt::adaptive_set<std::uint64_t> small;
+	for (std::uint64_t i = 0; i < 16; ++i) {
+		small.insert(i);
+	}
+	small.insert(top);
+	EXPECT_THAT(small.current_layout(), testing::Eq(adt::adaptive_set<std::uint64_t>::layout::tree));
+
+	adt::adaptive_set<std::uint64_t> dense;
+	for (std::uint64_t i = 0; i < 4096; ++i) {
+		dense.insert(i);
+	}
+	EXPECT_THAT(dense.current_layout(), testing::Eq(adt::adaptive_set<std::uint64_t>::layout::bitset));
+	dense.insert(top);
+	EXPECT_THAT(dense.current_layout(), testing::Eq(adt::adaptive_set<std::uint64_t>::layout::tree));
+	EXPECT_TRUE(dense.contains(top) && dense.contains(0) && dense.size() == 4097);
+}
+
+TEST(avl_tree, bulk_load_sorts_and_balances) {
+	std::mt19937_64 random(17);
+	std::vector<std::int64_t> values(300000);
+	for (std::int64_t& value : values) {
+		value = static_cast<std::int64_t>(random() % 200000) - 100000;
+	}
+
+	adt::avl_tree<std::int64_t> tree(values.begin(), values.end());
+	const std::set<std::int64_t> expected(values.begin(), values.end());
+	EXPECT_THAT(tree.size(), testing::Eq(expected.size()));
+	EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+	EXPECT_THAT(tree.height(), testing::Eq(static_cast<std::size_t>(std::bit_width(expected.size()))));
+
+	tree.insert(1000000);
+	EXPECT_TRUE(tree.contains(1000000));
+}
+
+TEST(bloom_filter, rejects_absent_values_without_false_negatives) {
+	adt::avl_tree<int> tree{1, 2, 3};
+	adt::bloom_filter<int> filter(20000);
+	tree.filter_with(&filter);
+	EXPECT_THAT(filter.insertions(), testing::Eq(3));
+
+	for (int i = 4; i <= 10000; ++i) {
+		tree.insert(i);
+	}
+	tree.erase(5000);
+
+	for (int i = 1; i <= 10000; ++i) {
+		EXPECT_THAT(tree.contains(i), testing::Eq(i != 5000));
+	}
+
+	std::size_t false_positives = 0;
+	for (int i = 10001; i <= 110000; ++i) {
+		false_positives += filter.may_contain(i);
+		EXPECT_FALSE(tree.contains(i));
+	}
+	EXPECT_THAT(false_positives, testing::Lt(2000));
+
+	// Bulk replacement rebuilds the filter from the new contents
+	adt::avl_tree<int> other{-1, -2};
+	tree = std::move(other);
+	EXPECT_TRUE(tree.contains(-1));
+	EXPECT_FALSE(filter.may_contain(1) && filter.may_contain(2) && filter.may_contain(3) && filter.may_contain(4));
+	EXPECT_THAT(filter.insertions(), testing::Eq(2));
+
+	tree.clear();
+	EXPECT_THAT(filter.insertions(), testing::Eq(0));
+}
+
+TEST(avl_tree, lookup_cache_drops_freed_nodes) {
+	adt::avl_tree<int> tree{5, 3, 8, 1, 4};
+	tree.cache_lookups(3);
+	EXPECT_THAT(tree.lookup_cache_slots(), testing::Eq(4));
+
+	for (int round = 0; round < 3; ++round) {
+		for (int value : {1, 3, 4, 5, 8}) {
+			EXPECT_THAT(*tree.find(value), testing::Eq(value));
+		}
+	}
+
+	// A freed node must not be served from the cache, even if its address is reused by the next insertion
+	tree.erase(4);
+	EXPECT_FALSE(tree.contains(4));
+	tree.insert(6);
+	EXPECT_FALSE(tree.contains(4));
+	EXPECT_TRUE(tree.contains(6));
+
+	// Nodes handed to another tree leave the cache of the tree they came from
+	adt::avl_tree<int> other = std::move(tree);
+	EXPECT_FALSE(tree.contains(5));
+	EXPECT_TRUE(other.contains(5));
+
+	tree = other;
+	tree.clear();
+	EXPECT_FALSE(tree.contains(1));
+	EXPECT_TRUE(other.contains(1));
+}
+
+TEST(avl_tree, sorted_batch_lookup) {
+	std::vector<int> values;
+	for (int i = 0; i < 1000; i += 3) {
+		values.push_back(i);
+	}
+	const adt::avl_tree<int> tree(values.begin(), values.end());
+
+	std::vector<int> keys{-5, 0, 0, 1, 3, 299, 300, 998, 999, 1500};
+	std::vector<std::pair<int, bool>> found;
+	tree.find_sorted_batch(keys, [&](int key, adt::avl_tree<int>::const_iterator position) {
+		EXPECT_TRUE(position == tree.end() || *position == key);
+		found.emplace_back(key, position != tree.end());
+	});
+
+	const std::vector<std::pair<int, bool>> expected{
+		{-5, false}, {0, true}, {0, true}, {1, false}, {3, true},
+		{299, false}, {300, true}, {998, false}, {999, true}, {1500, false}
+	};
+	EXPECT_THAT(found, testing::ContainerEq(expected));
+}
+
+TEST(tree_views, intersect_and_difference) {
+	std::vector<int> many;
+	for (int i = 0; i < 100000; ++i) {
+		many.push_back(i * 2);
+	}
+	const adt::avl_tree<int> huge(many.begin(), many.end());
+	const adt::avl_tree<int> small{-3, 4, 5, 1000, 1001, 150000, 199998, 200000};
+
+	const adt::intersect_view common(small, huge);
+	static_assert(std::ranges::forward_range<decltype(common)>);
+	EXPECT_THAT(std::vector<int>(common.begin(), common.end()),
+	            testing::ElementsAre(4, 1000, 150000, 199998));
+
+	const adt::difference_view missing(small, huge);
+	EXPECT_THAT(std::vector<int>(missing.begin(), missing.end()), testing::ElementsAre(-3, 5, 1001, 200000));
+
+	const adt::avl_tree<int> empty;
+	EXPECT_TRUE(std::ranges::empty(adt::intersect_view(huge, empty)));
+	EXPECT_THAT(std::ranges::distance(adt::difference_view(huge, empty)), testing::Eq(100000));
+	EXPECT_TRUE(std::ranges::empty(adt::difference_view(small, small)));
+}
+
+TEST(avl_tree, merge_all_reuses_nodes) {
+	std::pmr::monotonic_buffer_resource resource;
+	std::vector<adt::pmr::avl_tree<int>> parts;
+	std::set<int> expected;
+	for (int part = 0; part < 8; ++part) {
+		parts.emplace_back(&resource);
+		for (int i = part; i < 4000; i += 3 + part) {
+			parts.back().insert(i);
+			expected.insert(i);
+		}
+	}
+
+	// Where each value lives; duplicates may keep the node of any part holding them
+	std::map<int, std::vector<const int*>> addresses;
+	for (const adt::pmr::avl_tree<int>& part : parts) {
+		for (const int& value : part) {
+			addresses[value].push_back(&value);
+		}
+	}
+
+	adt::pmr::avl_tree<int> merged = adt::merge_all(parts);
+	EXPECT_TRUE(std::equal(merged.begin(), merged.end(), expected.begin(), expected.end()));
+	for (const int& value : merged) {
+		ASSERT_THAT(addresses[value], testing::Contains(&value));
+	}
+	EXPECT_THAT(merged.height(), testing::Eq(static_cast<std::size_t>(std::bit_width(expected.size()))));
+	EXPECT_TRUE(std::ranges::all_of(parts, [](const auto& part) { return part.empty(); }));
+
+	// Trees on different allocators are copied, and the sources are still emptied
+	adt::avl_tree<int> lhs{1, 3, 5};
+	adt::avl_tree<int> rhs{2, 3, 4};
+	std::pmr::unsynchronized_pool_resource pool;
+	adt::pmr::avl_tree<int> pooled({9, 0}, &pool);
+	adt::pmr::avl_tree<int> other({7}, &resource);
+	const adt::pmr::avl_tree<int> combined = adt::merge_all(pooled, other);
+	EXPECT_THAT(std::vector<int>(combined.begin(), combined.end()), testing::ElementsAre(0, 7, 9));
+	EXPECT_TRUE(other.empty());
+
+	const adt::avl_tree<int> both = adt::merge_all(lhs, rhs);
+	EXPECT_THAT(std::vector<int>(both.begin(), both.end()), testing::ElementsAre(1, 2, 3, 4, 5));
+	EXPECT_TRUE(lhs.empty() && rhs.empty());
+}
+
+TEST(logarithmic_set, matches_std_set) {
+	std::mt19937 random(91);
+	adt::logarithmic_set<int> set;
+	std::set<int> expected;
+
+	for (int step = 0; step < 20000; ++step) {
+		const int value = static_cast<int>(random() % 5000);
+		if (random() % 3 == 0) {
+			EXPECT_THAT(set.erase(value), testing::Eq(expected.erase(value)));
+		} else {
+			EXPECT_THAT(set.insert(value), testing::Eq(expected.insert(value).second));
+		}
+	}
+
+	EXPECT_THAT(set.size(), testing::Eq(expected.size()));
+	EXPECT_TRUE(std::equal(set.begin(), set.end(), expected.begin(), expected.end()));
+	EXPECT_THAT(set.levels_in_use(), testing::Le(static_cast<std::size_t>(std::bit_width(2 * expected.size()))));
+
+	for (int value = -1; value <= 5000; ++value) {
+		EXPECT_THAT(set.contains(value), testing::Eq(expected.contains(value)));
+		const auto bound = expected.lower_bound(value);
+		const auto position = set.lower_bound(value);
+		EXPECT_THAT(position == set.end(), testing::Eq(bound == expected.end()));
+		if (bound != expected.end()) {
+			EXPECT_THAT(*position, testing::Eq(*bound));
+		}
+	}
+
+	const adt::logarithmic_set<int> copy = set;
+	EXPECT_TRUE(copy == set);
+	set.clear();
+	EXPECT_TRUE(set.empty());
+	EXPECT_TRUE(set.begin() == set.end());
+}
+
+TEST(logarithmic_set, pmr_assignment_keeps_its_resource) {
+	std::array<std::byte, 1 << 16> buffer;
+	std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+	adt::pmr::logarithmic_set<int> pooled({1, 2, 3, 4, 5}, &arena);
+	pooled.erase(2);
+
+	adt::pmr::logarithmic_set<int> target{9};
+	target = pooled;
+	EXPECT_TRUE(target == pooled);
+	target = std::move(pooled);
+	EXPECT_THAT(target.get_allocator().resource(), testing::Eq(std::pmr::get_default_resource()));
+	EXPECT_THAT(std::vector(target.begin(), target.end()), testing::ElementsAre(1, 3, 4, 5));
+	target.insert(2);
+	EXPECT_THAT(target.size(), testing::Eq(5));
+}
+
+TEST(avl_tree, top_level_directory_follows_restructuring) {
+	adt::avl_tree<int> tree;
+	tree.index_top_levels(4);
+	EXPECT_THAT(tree.indexed_levels(), testing::Eq(4));
+
+	std::mt19937 random(92);
+	std::set<int> expected;
+	for (int step = 0; step < 20000; ++step) {
+		const int value = static_cast<int>(random() % 2000);
+		if (random() % 2 == 0) {
+			tree.insert(value);
+			expected.insert(value);
+		} else {
+			tree.erase(value);
+			expected.erase(value);
+		}
+
+		const int probe = static_cast<int>(random() % 2000);
+		ASSERT_THAT(tree.contains(probe), testing::Eq(expected.contains(probe)));
+	}
+
+	for (int value = -1; value <= 2000; ++value) {
+		EXPECT_THAT(tree.contains(value), testing::Eq(expected.contains(value)));
+	}
+
+	adt::avl_tree<int> other{1, 2, 3};
+	tree.swap(other);
+	EXPECT_TRUE(tree.contains(2));
+	EXPECT_FALSE(tree.contains(4));
+
+	tree.clear();
+	EXPECT_FALSE(tree.contains(2));
+	tree.insert(7);
+	EXPECT_TRUE(tree.contains(7));
+}
+
+TEST(optimal_tree, weighted_shape) {
+	// Zipfian weights over keys listed in a scrambled order
+	std::vector<int> keys;
+	std::vector<double> weights;
+	for (int rank = 1; rank <= 1024; ++rank) {
+		keys.push_back((rank * 389) % 1031);
+		weights.push_back(1.0 / rank);
+	}
+	keys.push_back(keys.front());
+	weights.push_back(1.0);
+
+	const adt::optimal_tree<int> tree = adt::build_optimal(keys, weights);
+	EXPECT_THAT(tree.size(), testing::Eq(1024));
+
+	double total = 0;
+	double weighted_depth = 0;
+	for (std::size_t i = 0; i < 1024; ++i) {
+		EXPECT_TRUE(tree.contains(keys[i]));
+		EXPECT_THAT(tree.index_of(keys[i]), testing::Optional(i));
+		total += weights[i];
+		weighted_depth += weights[i] * static_cast<double>(tree.depth(keys[i]));
+	}
+	EXPECT_THAT(tree.depth(keys.front()), testing::Lt(5));
+
+	// A perfectly balanced tree of 1024 keys averages just under 10 comparisons
+	EXPECT_THAT(weighted_depth / total, testing::Lt(8.0));
+
+	EXPECT_FALSE(tree.contains(-1));
+	EXPECT_FALSE(tree.contains(2000));
+	EXPECT_THAT(tree.index_of(2000), testing::Eq(std::nullopt));
+	EXPECT_THROW(adt::build_optimal(keys, std::vector<double>(3)), std::invalid_argument);
+}
+
+TEST(indexed_tree, point_index_tracks_the_tree) {
+	std::mt19937 random(94);
+	adt::indexed_tree<int> tree;
+	std::set<int> expected;
+	EXPECT_TRUE(tree.points_indexed());
+
+	for (int step = 0; step < 20000; ++step) {
+		const int value = static_cast<int>(random() % 3000);
+		if (random() % 3 == 0) {
+			EXPECT_THAT(tree.erase(value), testing::Eq(expected.erase(value)));
+		} else {
+			EXPECT_THAT(tree.insert(value).second, testing::Eq(expected.insert(value).second));
+		}
+	}
+
+	for (int value = -1; value <= 3000; ++value) {
+		const auto position = tree.find(value);
+		ASSERT_THAT(position != tree.end(), testing::Eq(expected.contains(value)));
+		if (position != tree.end()) {
+			EXPECT_THAT(*position, testing::Eq(value));
+		}
+	}
+	EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+
+	// Copies index their own nodes, and the index moves with the nodes
+	adt::indexed_tree<int> copy = tree;
+	copy.erase(*expected.begin());
+	EXPECT_TRUE(tree.contains(*expected.begin()));
+	EXPECT_FALSE(copy.contains(*expected.begin()));
+
+	adt::indexed_tree<int> moved = std::move(copy);
+	EXPECT_TRUE(moved.points_indexed());
+	EXPECT_TRUE(moved.contains(*expected.rbegin()));
+
+	const std::vector<int> values{5, 1, 5, 3};
+	adt::indexed_tree<int> bulk(values.begin(), values.end());
+	EXPECT_TRUE(bulk.contains(3));
+	bulk.clear();
+	EXPECT_FALSE(bulk.contains(3));
+	bulk.swap(moved);
+	EXPECT_TRUE(bulk.contains(*expected.rbegin()));
+	EXPECT_FALSE(moved.contains(*expected.rbegin()));
+}
+
+TEST(tiered_tree, spills_cold_runs_and_faults_them_back) {
+	adt::tiered_tree<int> tree(1000 * 64);
+	for (int i = 0; i < 10000; ++i) {
+		tree.insert(i);
+	}
+
+	// Keep a few values hot across two windows, so that they stay resident
+	for (int round = 0; round < 3; ++round) {
+		for (int i = 0; i < 10000; i += 500) {
+			EXPECT_TRUE(tree.find(i) != tree.end());
+		}
+		tree.enforce_budget();
+	}
+
+	EXPECT_THAT(tree.size(), testing::Eq(10000));
+	EXPECT_THAT(tree.spilled(), testing::Gt(0));
+	EXPECT_THAT(tree.resident(), testing::Lt(10000));
+	EXPECT_THAT(tree.resident() + tree.spilled(), testing::Eq(10000));
+	for (int i = 0; i < 10000; i += 500) {
+		EXPECT_TRUE(std::find(tree.begin(), tree.end(), i) != tree.end());
+	}
+
+	// Reads see spilled values in place; writes fault their run back in first
+	for (int i = -1; i <= 10000; ++i) {
+		ASSERT_THAT(tree.contains(i), testing::Eq(i >= 0 && i < 10000));
+	}
+	EXPECT_TRUE(tree.insert(-5).second);
+	EXPECT_FALSE(tree.insert(1).second);
+	EXPECT_THAT(tree.erase(2), testing::Eq(1));
+	EXPECT_THAT(tree.size(), testing::Eq(10000));
+
+	tree.restore();
+	EXPECT_THAT(tree.spilled(), testing::Eq(0));
+	std::vector<int> expected{-5, 0, 1};
+	for (int i = 3; i < 10000; ++i) {
+		expected.push_back(i);
+	}
+	EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+}
+
+TEST(tiered_tree, reads_keep_values_warm_and_freed_records_are_reused) {
+	adt::tiered_tree<int> tree(100 * 64);
+	for (int i = 0; i < 1000; ++i) {
+		tree.insert(i);
+	}
+
+	// Values only ever read through `contains` or a const `find` count as used
+	const adt::tiered_tree<int>& view = tree;
+	for (int round = 0; round < 3; ++round) {
+		EXPECT_TRUE(tree.contains(10));
+		EXPECT_TRUE(view.find(900) != view.end());
+		tree.enforce_budget();
+	}
+	EXPECT_THAT(tree.spilled(), testing::Gt(0));
+	EXPECT_TRUE(std::find(tree.begin(), tree.end(), 10) != tree.end());
+	EXPECT_TRUE(std::find(tree.begin(), tree.end(), 900) != tree.end());
+	tree.erase(view.find(900));
+	EXPECT_THAT(tree.size(), testing::Eq(999));
+
+	adt::spill_file file;
+	const std::vector<int> record(200, 7);
+	const std::size_t first = file.append(record.data(), 400);
+	const std::size_t second = file.append(record.data(), 400);
+	file.append(record.data(), 400);
+	const std::size_t size = file.size();
+	file.release(second, 400);
+	file.release(first, 400);
+	EXPECT_THAT(file.append(record.data(), 800), testing::Eq(first));
+	EXPECT_THAT(file.size(), testing::Eq(size));
+}
+
+TEST(tiered_tree, moves_swaps_and_merges_carry_spilled_runs) {
+	const auto spill = [](adt::tiered_tree<int>& tree, int first, int last) {
+		for (int i = first; i < last; ++i) {
+			tree.insert(i);
+		}
+		tree.enforce_budget();
+		tree.enforce_budget();
+	};
+
+	adt::tiered_tree<int> a(100 * 64);
+	spill(a, 0, 1000);
+	ASSERT_THAT(a.spilled(), testing::Gt(0));
+
+	adt::tiered_tree<int> moved(std::move(a));
+	EXPECT_TRUE(a.empty());
+	EXPECT_THAT(a.size(), testing::Eq(0));
+	EXPECT_THAT(moved.size(), testing::Eq(1000));
+	EXPECT_TRUE(moved.contains(5));
+
+	adt::tiered_tree<int> b(100 * 64);
+	spill(b, 2000, 2500);
+	moved.swap(b);
+	EXPECT_THAT(moved.size(), testing::Eq(500));
+	EXPECT_THAT(b.size(), testing::Eq(1000));
+	EXPECT_TRUE(b.contains(5) && !b.contains(2005));
+	EXPECT_TRUE(moved.contains(2005) && !moved.contains(5));
+
+	b = std::move(moved);
+	EXPECT_THAT(b.size(), testing::Eq(500));
+	EXPECT_TRUE(moved.empty());
+
+	adt::tiered_tree<int> c(100 * 64);
+	spill(c, 0, 1000);
+	adt::tiered_tree<int>::binary_tree* sources[] = {&c};
+	b.absorb(sources);
+	EXPECT_TRUE(c.empty());
+	EXPECT_THAT(b.size(), testing::Eq(1500));
+	EXPECT_THAT(b.spilled(), testing::Eq(0));
+}
+
+TEST(tiered_tree, spills_only_down_to_the_budget) {
+	adt::tiered_tree<int> tree(0);
+	for (int i = 0; i < 1000; ++i) {
+		tree.insert(i);
+	}
+	const std::size_t node = tree.resident_bytes() / 1000;
+
+	adt::tiered_tree<int> bounded(130 * node);
+	for (int i = 0; i < 1000; ++i) {
+		bounded.insert(i);
+	}
+	bounded.enforce_budget();
+	bounded.enforce_budget();
+	EXPECT_THAT(bounded.resident(), testing::Eq(130));
+	EXPECT_THAT(bounded.size(), testing::Eq(1000));
+	EXPECT_TRUE(bounded.contains(0) && bounded.contains(999));
+}
+
+TEST(lazy_tree, tombstones_are_invisible_and_purged_in_batches) {
+	std::mt19937 random(96);
+	adt::lazy_tree<int> tree;
+	std::set<int> expected;
+
+	for (int step = 0; step < 20000; ++step) {
+		const int value = static_cast<int>(random() % 2000);
+		if (random() % 2 == 0) {
+			EXPECT_THAT(tree.erase(value), testing::Eq(expected.erase(value)));
+		} else {
+			EXPECT_THAT(tree.insert(value).second, testing::Eq(expected.insert(value).second));
+		}
+		ASSERT_THAT(tree.tombstones(), testing::Le(tree.size()));
+	}
+
+	EXPECT_THAT(tree.size(), testing::Eq(expected.size()));
+	for (int value = -1; value <= 2000; ++value) {
+		ASSERT_THAT(tree.contains(value), testing::Eq(expected.contains(value)));
+		const auto bound = expected.lower_bound(value);
+		ASSERT_THAT(tree.lower_bound(value) == tree.end(), testing::Eq(bound == expected.end()));
+		if (bound != expected.end()) {
+			ASSERT_THAT(*tree.lower_bound(value), testing::Eq(*bound));
+		}
+	}
+	EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+	EXPECT_TRUE(std::equal(tree.rbegin(), tree.rend(), expected.rbegin(), expected.rend()));
+
+	// Erasing by position skips over dead neighbours, and a purge leaves only live nodes behind
+	const int first = *expected.begin();
+	tree.erase(*std::next(expected.begin()));
+	EXPECT_THAT(*tree.erase(tree.begin()), testing::Eq(*std::next(expected.begin(), 2)));
+	EXPECT_FALSE(tree.contains(first));
+	EXPECT_THAT(tree.tombstones(), testing::Gt(0));
+
+	adt::avl_tree<int> plain(std::next(expected.begin(), 2), expected.end());
+	tree.purge();
+	EXPECT_THAT(tree.tombstones(), testing::Eq(0));
+	EXPECT_THAT(tree.height(), testing::Le(plain.height()));
+	EXPECT_TRUE(std::equal(tree.begin(), tree.end(), plain.begin(), plain.end()));
+
+	// Reinserting a dead value revives its node
+	tree.erase(first + 1000);
+	EXPECT_TRUE(tree.insert(first).second);
+	EXPECT_TRUE(tree.contains(first));
+}
+
+TEST(lazy_tree, absorbing_drops_tombstones_from_every_tree) {
+	adt::lazy_tree<int> first{1, 2, 3, 4, 5};
+	adt::lazy_tree<int> second{4, 5, 6, 7, 8};
+	first.erase(2);
+	second.erase(7);
+	EXPECT_THAT(first.tombstones() + second.tombstones(), testing::Eq(2));
+
+	const adt::lazy_tree<int> merged = adt::merge_all(first, second);
+	EXPECT_THAT(merged.tombstones(), testing::Eq(0));
+	EXPECT_THAT(first.tombstones() + second.tombstones(), testing::Eq(0));
+	EXPECT_THAT(std::vector(merged.begin(), merged.end()), testing::ElementsAre(1, 3, 4, 5, 6, 8));
+
+	// The counts stay right, so tombstones again trigger a purge once they outnumber the live values
+	second.insert({1, 2});
+	second.erase(1);
+	second.erase(2);
+	EXPECT_THAT(second.tombstones(), testing::Eq(0));
+	EXPECT_TRUE(second.empty());
+}
+
+TEST(lazy_tree, swaps_and_moves_keep_tombstone_counts) {
+	adt::lazy_tree<int> a{1, 2, 3};
+	adt::lazy_tree<int> b{4, 5, 6, 7, 8};
+	b.erase(4);
+	b.erase(5);
+	a.swap(b);
+	EXPECT_THAT(a.tombstones(), testing::Eq(2));
+	EXPECT_THAT(b.tombstones(), testing::Eq(0));
+	swap(a, b);
+	b.purge();
+	EXPECT_THAT(b.tombstones(), testing::Eq(0));
+	EXPECT_THAT(std::vector(b.begin(), b.end()), testing::ElementsAre(6, 7, 8));
+
+	// Across resources the nodes, dead ones included, are copied and the source keeps its own
+	std::pmr::unsynchronized_pool_resource pool;
+	adt::pmr::lazy_tree<int> source({1, 2, 3, 4, 5, 6, 7, 8, 9, 10}, &pool);
+	source.erase(1);
+	source.erase(2);
+	adt::pmr::lazy_tree<int> target;
+	target = std::move(source);
+	EXPECT_THAT(source.size(), testing::Eq(8));
+	EXPECT_THAT(source.tombstones(), testing::Eq(2));
+	EXPECT_THAT(target.tombstones(), testing::Eq(2));
+	source.purge();
+	EXPECT_THAT(source.tombstones(), testing::Eq(0));
+	EXPECT_THAT(std::vector(source.begin(), source.end()), testing::ElementsAre(3, 4, 5, 6, 7, 8, 9, 10));
+}
+
+TEST(relaxed_tree, defers_rotations_until_rebalanced) {
+	std::mt19937 random(97);
+	adt::relaxed_tree<int> tree;
+	std::set<int> expected;
+
+	// Ascending inserts leave a path behind until the fix-ups run
+	for (int i = 0; i < 1000; ++i) {
+		tree.insert(i);
+		expected.insert(i);
+	}
+	EXPECT_THAT(tree.height(), testing::Eq(1000));
+	EXPECT_THAT(tree.pending_fixups(), testing::Gt(0));
+
+	while (!tree.rebalance_step(16)) {}
+	EXPECT_THAT(tree.height(), testing::Le(15));
+
+	for (int step = 0; step < 20000; ++step) {
+		const int value = static_cast<int>(random() % 3000);
+		if (random() % 3 == 0) {
+			EXPECT_THAT(tree.erase(value), testing::Eq(expected.erase(value)));
+		} else {
+			EXPECT_THAT(tree.insert(value).second, testing::Eq(expected.insert(value).second));
+		}
+		if (step % 7 == 0) {
+			tree.rebalance_step(8);
+		}
+	}
+	EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+
+	// Copies queue their own nodes
+	adt::relaxed_tree<int> copy = tree;
+	copy.rebalance();
+	tree.rebalance();
+	EXPECT_THAT(copy.pending_fixups(), testing::Eq(0));
+	EXPECT_THAT(tree.height(), testing::Le(static_cast<std::size_t>(1.45 * std::log2(expected.size() + 2))));
+	EXPECT_THAT(copy.height(), testing::Eq(tree.height()));
+	EXPECT_TRUE(copy == tree);
+
+	// A background worker settles the tree while writers share the lock with it
+	std::mutex mutex;
+	{
+		adt::background_rebalancer rebalancer(tree, mutex, 32);
+		for (int i = 3000; i < 6000; ++i) {
+			std::lock_guard lock(mutex);
+			tree.insert(i);
+		}
+		for (bool balanced = false; !balanced;) {
+			std::this_thread::yield();
+			std::lock_guard lock(mutex);
+			balanced = tree.pending_fixups() == 0;
+		}
+	}
+	EXPECT_THAT(tree.size(), testing::Eq(expected.size() + 3000));
+	EXPECT_THAT(tree.height(), testing::Le(static_cast<std::size_t>(1.45 * std::log2(tree.size() + 2))));
+}
+
+TEST(combining_tree, concurrent_updates_match_sequential_result) {
+	adt::combining_tree<adt::avl_tree<int>> tree;
+	std::atomic<int> misses = 0;
+
+	// Each thread inserts its own residue class, erases the even members and checks the rest
+	std::vector<std::thread> threads;
+	for (int thread = 0; thread < 8; ++thread) {
+		threads.emplace_back([&tree, &misses, thread] {
+			for (int value = thread; value < 8000; value += 8) {
+				misses += !tree.insert(value);
+			}
+			for (int value = thread; value < 8000; value += 8) {
+				if (value % 2 == 0) {
+					misses += !tree.erase(value);
+				}
+			}
+			for (int value = thread; value < 8000; value += 8) {
+				misses += tree.contains(value) != (value % 2 != 0);
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_THAT(misses.load(), testing::Eq(0));
+	EXPECT_THAT(tree.size(), testing::Eq(4000));
+	EXPECT_FALSE(tree.insert(1));
+	EXPECT_TRUE(tree.apply([](const adt::avl_tree<int>& engine) {
+		return std::all_of(engine.begin(), engine.end(), [](int value) { return value % 2 != 0; });
+	}));
+}
+
+// Engine whose insertions of negative values throw
+class rejecting_tree : public adt::avl_tree<int> {
+public:
+	std::pair<iterator, bool> insert(const int& value) {
+		if (value < 0) {
+			throw std::invalid_argument("negative value");
+		}
+		return adt::avl_tree<int>::insert(value);
+	}
+};
+
+TEST(combining_tree, exceptions_reach_their_own_publisher) {
+	adt::combining_tree<rejecting_tree> tree;
+	EXPECT_THROW(tree.insert(-1), std::invalid_argument);
+	EXPECT_TRUE(tree.insert(1));
+
+	std::atomic<int> thrown = 0;
+	std::atomic<int> misses = 0;
+	std::vector<std::thread> threads;
+	for (int thread = 0; thread < 8; ++thread) {
+		threads.emplace_back([&tree, &thrown, &misses, thread] {
+			for (int value = thread + 8; value < 4000; value += 8) {
+				try {
+					misses += !tree.insert(thread % 2 == 0 ? value : -value);
+				} catch (const std::invalid_argument&) {
+					thrown += thread % 2 == 0 ? 1000000 : 1;
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_THAT(misses.load(), testing::Eq(0));
+	EXPECT_THAT(thrown.load(), testing::Eq(4 * 499));
+	EXPECT_THAT(tree.size(), testing::Eq(1 + 4 * 499));
+}
+
+TEST(swappable_index, readers_keep_their_version_across_swaps) {
+	const std::vector<int> initial{3, 1, 2};
+	adt::swappable_index<adt::avl_tree<int>> index(adt::avl_tree<int>(initial.begin(), initial.end()));
+
+	const auto before = index.snapshot();
+	index.update([](adt::avl_tree<int>& tree) {
+		tree.insert(4);
+		tree.erase(1);
+	});
+	EXPECT_THAT(index.version(), testing::Eq(1));
+	EXPECT_TRUE(before->contains(1));
+	EXPECT_FALSE(before->contains(4));
+	EXPECT_TRUE(index.snapshot()->contains(4));
+	EXPECT_FALSE(index.snapshot()->contains(1));
+
+	// Accelerators that would write on lookup are settled or dropped before a version is shared
+	index.update([](adt::avl_tree<int>& tree) {
+		tree.cache_lookups(16);
+		tree.index_top_levels(2);
+	});
+	EXPECT_THAT(index.snapshot()->lookup_cache_slots(), testing::Eq(0));
+	EXPECT_THAT(index.snapshot()->indexed_levels(), testing::Eq(2));
+	EXPECT_TRUE(index.snapshot()->contains(4));
+
+	// Readers run against whatever version is current while a builder keeps replacing it
+	std::atomic<bool> stop = false;
+	std::atomic<int> torn = 0;
+	std::thread reader([&] {
+		while (!stop.load()) {
+			const auto tree = index.snapshot();
+			const int low = *tree->begin();
+			torn += static_cast<int>(tree->size()) != 100 && tree->size() != 3;
+			torn += tree->size() == 100 && !tree->contains(low + 99);
+		}
+	});
+	for (int round = 0; round < 200; ++round) {
+		std::vector<int> values(100);
+		std::iota(values.begin(), values.end(), round * 100);
+		index.rebuild(values.begin(), values.end());
+	}
+	stop = true;
+	reader.join();
+
+	EXPECT_THAT(torn.load(), testing::Eq(0));
+	EXPECT_THAT(index.version(), testing::Eq(202));
+	EXPECT_THAT(*index.snapshot()->begin(), testing::Eq(19900));
+	EXPECT_THAT(before.use_count(), testing::Eq(1));
+}
+
+TEST(mvcc_tree, snapshots_scan_a_consistent_past) {
+	adt::mvcc_tree<int> tree;
+	for (int i = 0; i < 100; ++i) {
+		tree.insert(i);
+	}
+
+	auto before = tree.snapshot();
+	for (int i = 0; i < 100; i += 2) {
+		tree.erase(i);
+	}
+	tree.insert(200);
+	tree.insert(10);
+
+	// The present skips closed versions; the snapshot still sees every value it was taken with
+	EXPECT_THAT(tree.size(), testing::Eq(52));
+	EXPECT_FALSE(tree.contains(4));
+	EXPECT_TRUE(tree.contains(10));
+	EXPECT_THAT(*tree.begin(), testing::Eq(1));
+	EXPECT_TRUE(before.contains(4));
+	EXPECT_FALSE(before.contains(200));
+
+	// Writes between the steps of a scan do not change what it reads, even when they rebalance or collect
+	std::vector<int> seen;
+	before.scan(10, 60, [&](int value) {
+		seen.push_back(value);
+		tree.erase(value + 1);
+		tree.insert(1000 + value);
+	});
+	std::vector<int> expected(50);
+	std::iota(expected.begin(), expected.end(), 10);
+	EXPECT_EQ(seen, expected);
+
+	auto after = tree.snapshot();
+	tree.erase(10);
+	before.release();
+	tree.collect();
+	EXPECT_TRUE(after.contains(10));
+	EXPECT_FALSE(after.contains(4));
+	EXPECT_TRUE(after.contains(1010));
+
+	// Once nothing can see the closed versions, they are freed
+	after.release();
+	tree.collect();
+	EXPECT_THAT(tree.versions(), testing::Eq(tree.size()));
+	std::vector<int> present;
+	tree.snapshot().for_each([&](int value) { present.push_back(value); });
+	EXPECT_TRUE(std::equal(tree.begin(), tree.end(), present.begin(), present.end()));
+
+	// Clearing closes only the live versions, leaving earlier closed ones as a snapshot saw them
+	auto last = tree.snapshot();
+	tree.erase(1);
+	tree.clear();
+	EXPECT_TRUE(tree.empty());
+	EXPECT_FALSE(last.contains(0));
+	EXPECT_TRUE(last.contains(1));
+	EXPECT_TRUE(last.contains(200));
+	last.release();
+	EXPECT_THAT(tree.versions(), testing::Eq(0));
+}
+
+TEST(mvcc_tree, reclaims_versions_as_snapshots_release) {
+	adt::mvcc_tree<int> tree;
+	for (int i = 0; i < 100; ++i) {
+		tree.insert(i);
+	}
+
+	// Versions opened and closed after the only snapshot are freed as they close
+	auto snapshot = tree.snapshot();
+	for (int round = 0; round < 1000; ++round) {
+		tree.insert(1000 + round);
+		tree.erase(1000 + round);
+	}
+	EXPECT_THAT(tree.versions(), testing::Eq(100));
+
+	// Versions the snapshot can read wait for it, and go without a `collect()` once it is released
+	for (int i = 0; i < 100; i += 2) {
+		tree.erase(i);
+	}
+	tree.insert(0);
+	EXPECT_THAT(tree.versions(), testing::Eq(100));
+	EXPECT_TRUE(snapshot.contains(2));
+	snapshot.release();
+	EXPECT_THAT(tree.versions(), testing::Eq(tree.size()));
+	EXPECT_THAT(tree.size(), testing::Eq(51));
+
+	// Absorbing inserts new versions and clears the sources, so snapshots on both sides keep what they saw
+	adt::mvcc_tree<int> other{500, 501, 600};
+	auto mine = tree.snapshot();
+	auto theirs = other.snapshot();
+	adt::mvcc_tree<int>::binary_tree* sources[] = {&other};
+	tree.absorb(sources);
+	EXPECT_THAT(tree.size(), testing::Eq(54));
+	EXPECT_TRUE(other.empty());
+	EXPECT_FALSE(mine.contains(500));
+	EXPECT_TRUE(theirs.contains(501));
+	theirs.release();
+	EXPECT_THAT(other.versions(), testing::Eq(0));
+	mine.release();
+	EXPECT_THAT(tree.versions(), testing::Eq(54));
+}
@@ -0,0 +1,130 @@
+#ifndef BLOOM_FILTER_HPP
+#define BLOOM_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <array>
+#include <functional>
+#include <concepts>
+#include <algorithm>
+
+
+namespace adt {
+
+    template<class T, class Hash = std::hash<T>>
+    concept hashable = requires(const Hash& hash, const T& value) {
+        { hash(value) } -> std::convertible_to<std::size_t>;
+    };
+
+    /* ------------------------------------------------Bloom Filter------------------------------------------------- */
+    // Split-block Bloom filter: every value sets one bit in each of the eight 64-bit words of a single 64-byte block,
+    // so a lookup costs one cache line no matter how many bits are probed. Values cannot be removed; erased values
+    // keep their bits until the filter is rebuilt, which only raises the false-positive rate. With the default ten
+    // bits per value the false-positive rate is about 1%.
+    template<class T, class Hash = std::hash<T>, class Allocator = std::allocator<T>>
+    class bloom_filter {
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using value_type = T;
+
+        using hasher = Hash;
+
+        using allocator_type = Allocator;
+
+        using size_type = std::size_t;
+
+    protected:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        struct alignas(64) _Block {
+            std::array<std::uint64_t, 8> words{};
+        };
+
+        using _BlockAllocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<_Block>;
+
+        // Odd multipliers that pick one bit per word from the low half of the hash
+        static constexpr std::array<std::uint32_t, 8> salts = {
+            0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+        };
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        std::vector<_Block, _BlockAllocator> blocks;
+
+        size_type count = 0;
+
+        [[no_unique_address]] hasher hash;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] std::uint64_t _mix(const value_type& value) const noexcept {
+            // splitmix64 finalizer, so that weak hashes (identity for integers) still spread over blocks and bits
+            std::uint64_t hashed = static_cast<std::uint64_t>(this->hash(value));
+            hashed = (hashed ^ (hashed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            hashed = (hashed ^ (hashed >> 27)) * 0x94d049bb133111ebULL;
+            return hashed ^ (hashed >> 31);
+        }
+
+        [[nodiscard]] size_type _block_of(std::uint64_t hashed) const noexcept {
+            // Multiply-shift range reduction on the high half, instead of a modulo
+            return static_cast<size_type>(((hashed >> 32) * this->blocks.size()) >> 32);
+        }
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        explicit bloom_filter(size_type expected,
+                              size_type bits_per_value = 10,
+                              const hasher& hash = hasher(),
+                              const allocator_type& allocator = allocator_type())
+            : blocks(std::max<size_type>(1, (expected * bits_per_value + 511) / 512),
+                     _Block(),
+                     _BlockAllocator(allocator)),
+              hash(hash) {}
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        void insert(const value_type& value) noexcept {
+            const std::uint64_t hashed = this->_mix(value);
+            _Block& block = this->blocks[this->_block_of(hashed)];
+            const auto low = static_cast<std::uint32_t>(hashed);
+
+            for (std::size_t i = 0; i < 8; ++i) {
+                block.words[i] |= std::uint64_t(1) << ((low * salts[i]) >> 26);
+            }
+
+            ++this->count;
+        }
+
+        // False means `value` was never inserted since the last `clear`; true means it probably was
+        [[nodiscard]] bool may_contain(const value_type& value) const noexcept {
+            const std::uint64_t hashed = this->_mix(value);
+            const _Block& block = this->blocks[this->_block_of(hashed)];
+            const auto low = static_cast<std::uint32_t>(hashed);
+
+            // Accumulate instead of returning early, so the eight tests do not become eight branches
+            std::uint64_t missing = 0;
+            for (std::size_t i = 0; i < 8; ++i) {
+                missing |= ~block.words[i] & (std::uint64_t(1) << ((low * salts[i]) >> 26));
+            }
+
+            return missing == 0;
+        }
+
+        void clear() noexcept {
+            std::fill(this->blocks.begin(), this->blocks.end(), _Block());
+            this->count = 0;
+        }
+
+        // Insertions since the last `clear`, duplicates and since-erased values included
+        [[nodiscard]] size_type insertions() const noexcept { return this->count; }
+
+        [[nodiscard]] size_type bits() const noexcept { return this->blocks.size() * 512; }
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept {
+            return allocator_type(this->blocks.get_allocator());
+        }
+
+    };
+
+} // adt
+
+
+#endif // BLOOM_FILTER_HPP
@@ -0,0 +1,162 @@
+#ifndef CHANGE_FEED_HPP
+#define CHANGE_FEED_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <limits>
+#include <bit>
+#include <new>
+
+
+namespace adt {
+
+    /* ------------------------------------------------Change Kind-------------------------------------------------- */
+    enum class change_kind : std::uint8_t {
+        insert,
+
+        erase,
+
+        // The whole container was replaced (cleared, assigned or swapped), so consumers must re-scan it
+        reset
+    };
+
+    /* -----------------------------------------------Change Record------------------------------------------------- */
+    template<class T>
+    struct change_record {
+        /* ----------------------------------------------Fields----------------------------------------------------- */
+        change_kind kind;
+
+        T value;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        [[nodiscard]] constexpr bool operator==(const change_record&) const noexcept = default;
+
+    };
+
+    /* ------------------------------------------------Change Feed-------------------------------------------------- */
+    // A bounded, lock-free, single-producer/single-consumer ring of change records. The producer is the thread that
+    // mutates the observed container; the consumer drains records in batches, publishing its progress once per batch.
+    // When the ring is full new records are dropped and `overflowed()` is raised, after which the consumer should
+    // re-scan the container instead of trusting the feed.
+    template<class T, class Allocator = std::allocator<change_record<T>>>
+    class change_feed {
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using value_type = change_record<T>;
+
+        using allocator_type = Allocator;
+
+        using size_type = std::size_t;
+
+    protected:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        static constexpr size_type cache_line = 64;
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        std::vector<value_type, allocator_type> records;
+
+        size_type mask;
+
+        // Written by the consumer, read by the producer
+        alignas(cache_line) std::atomic<size_type> head;
+
+        // Consumer-local copy of `tail`, refreshed only when the consumer runs out of records
+        size_type cached_tail;
+
+        // Written by the producer, read by the consumer
+        alignas(cache_line) std::atomic<size_type> tail;
+
+        // Producer-local copy of `head`, refreshed only when the producer runs out of space
+        size_type cached_head;
+
+        std::atomic<bool> overflow;
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        explicit change_feed(size_type capacity, const allocator_type& allocator = allocator_type())
+            : records(std::bit_ceil(std::max<size_type>(capacity, 2)), value_type(), allocator),
+              mask(records.size() - 1),
+              head(0),
+              cached_tail(0),
+              tail(0),
+              cached_head(0),
+              overflow(false) {}
+
+        change_feed(const change_feed&) = delete;
+
+        change_feed(change_feed&&) = delete;
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~change_feed() noexcept = default;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        change_feed& operator=(const change_feed&) = delete;
+
+        change_feed& operator=(change_feed&&) = delete;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] size_type capacity() const noexcept { return this->records.size(); }
+
+        // Only exact when called from the producer or the consumer while the other side is idle
+        [[nodiscard]] size_type size() const noexcept {
+            return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] bool empty() const noexcept { return this->size() == 0; }
+
+        [[nodiscard]] bool overflowed() const noexcept { return this->overflow.load(std::memory_order_acquire); }
+
+        // Called by the consumer once it has re-synchronised after an overflow
+        bool reset_overflow() noexcept { return this->overflow.exchange(false, std::memory_order_acq_rel); }
+
+        // Producer side
+        bool push(change_kind kind, const T& value) noexcept {
+            const size_type position = this->tail.load(std::memory_order_relaxed);
+
+            // Only look at the consumer's index when our cached copy says the ring is full
+            if (position - this->cached_head == this->records.size()) {
+                this->cached_head = this->head.load(std::memory_order_acquire);
+                if (position - this->cached_head == this->records.size()) {
+                    this->overflow.store(true, std::memory_order_release);
+                    return false;
+                }
+            }
+
+            value_type& record = this->records[position & this->mask];
+            record.kind = kind;
+            record.value = value;
+
+            this->tail.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side: calls `visitor(record)` for up to `limit` records, then releases them all at once
+        template<class Visitor>
+        size_type drain(Visitor visitor, size_type limit = std::numeric_limits<size_type>::max()) {
+            const size_type position = this->head.load(std::memory_order_relaxed);
+
+            if (this->cached_tail == position) {
+                this->cached_tail = this->tail.load(std::memory_order_acquire);
+            }
+
+            const size_type count = std::min(this->cached_tail - position, limit);
+            for (size_type i = 0; i < count; ++i) {
+                visitor(static_cast<const value_type&>(this->records[(position + i) & this->mask]));
+            }
+
+            this->head.store(position + count, std::memory_order_release);
+            return count;
+        }
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept { return this->records.get_allocator(); }
+
+    };
+
+} // adt
+
+
+#endif // CHANGE_FEED_HPP
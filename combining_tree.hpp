@@ -0,0 +1,194 @@
+#ifndef COMBINING_TREE_HPP
+#define COMBINING_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <exception>
+#include <type_traits>
+
+#include "binary_tree.hpp"
+
+
+namespace adt {
+
+    /* -----------------------------------------------Combining Tree------------------------------------------------ */
+    // Flat-combining wrapper that makes any sequential tree engine safe to share between threads. A thread publishes
+    // its operation in a slot and then either finds it done or takes the lock and becomes the combiner: it collects
+    // every published operation, sorts them by value and runs the batch against the engine, so one thread walks the
+    // tree with warm caches instead of many threads contending for it. Slots are picked per thread from `Slots`
+    // cache-line-sized entries; threads beyond that share slots and wait for a free one.
+    template<class Engine, std::size_t Slots = 64>
+        requires requires { typename Engine::binary_tree; }
+    class combining_tree {
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using engine_type = Engine;
+
+        using value_type = typename Engine::value_type;
+
+        using size_type = typename Engine::size_type;
+
+        using const_reference = typename Engine::const_reference;
+
+    protected:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        enum class _Operation : std::uint8_t { insert, erase, contains };
+
+        enum class _State : std::uint8_t { free, claimed, pending, done };
+
+        // One slot per cache line, so publishing threads do not false-share with each other
+        struct alignas(64) _Slot {
+            /* --------------------------------------------Fields--------------------------------------------------- */
+            std::atomic<_State> state = _State::free;
+
+            _Operation operation = _Operation::contains;
+
+            bool result = false;
+
+            // Set instead of `result` when the operation threw, for the publisher to rethrow
+            std::exception_ptr error;
+
+            // Points at the publisher's argument, which outlives the operation since the publisher waits for it
+            const value_type* value = nullptr;
+        };
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        Engine engine;
+
+        std::mutex mutex;
+
+        std::array<_Slot, Slots> slots;
+
+        // Scratch space for the combiner's batch, reused across batches
+        std::vector<_Slot*> batch;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] static std::size_t _home() noexcept {
+            static std::atomic<std::size_t> threads = 0;
+            thread_local const std::size_t home = threads.fetch_add(1, std::memory_order_relaxed);
+            return home % Slots;
+        }
+
+        [[nodiscard]] bool _run(_Operation operation, const_reference value) {
+            if constexpr (requires { this->engine.insert(value).second; }) {
+                if (operation == _Operation::insert) {
+                    return this->engine.insert(value).second;
+                }
+            } else {
+                if (operation == _Operation::insert) {
+                    return this->engine.insert(value);
+                }
+            }
+
+            if (operation == _Operation::erase) {
+                return this->engine.erase(value) != 0;
+            }
+
+            return this->engine.contains(value);
+        }
+
+        void _combine() {
+            this->batch.clear();
+            for (_Slot& slot : this->slots) {
+                if (slot.state.load(std::memory_order_acquire) == _State::pending) {
+                    this->batch.push_back(&slot);
+                }
+            }
+
+            // In value order, successive operations descend mostly the same paths
+            std::ranges::sort(this->batch, [](const _Slot* lhs, const _Slot* rhs) { return *lhs->value < *rhs->value; });
+
+            // An operation that throws fails only its own publisher, never the combiner or the rest of the batch
+            for (_Slot* slot : this->batch) {
+                try {
+                    slot->result = this->_run(slot->operation, *slot->value);
+                } catch (...) {
+                    slot->error = std::current_exception();
+                }
+                slot->state.store(_State::done, std::memory_order_release);
+            }
+        }
+
+        [[nodiscard]] bool _publish(_Operation operation, const_reference value) {
+            // Claim the home slot, or the next free one if another thread holds it
+            _Slot* slot = nullptr;
+            for (std::size_t index = _home(); slot == nullptr; index = (index + 1) % Slots) {
+                _State expected = _State::free;
+                if (this->slots[index].state.compare_exchange_weak(expected,
+                                                                   _State::claimed,
+                                                                   std::memory_order_acquire,
+                                                                   std::memory_order_relaxed)) {
+                    slot = &this->slots[index];
+                } else if (index + 1 == Slots) {
+                    std::this_thread::yield();
+                }
+            }
+
+            slot->operation = operation;
+            slot->value = &value;
+            slot->state.store(_State::pending, std::memory_order_release);
+
+            while (slot->state.load(std::memory_order_acquire) != _State::done) {
+                if (this->mutex.try_lock()) {
+                    std::lock_guard lock(this->mutex, std::adopt_lock);
+                    this->_combine();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+
+            const bool result = slot->result;
+            const std::exception_ptr error = std::exchange(slot->error, nullptr);
+            slot->state.store(_State::free, std::memory_order_release);
+
+            if (error != nullptr) {
+                std::rethrow_exception(error);
+            }
+            return result;
+        }
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        template<class... Args>
+            requires std::is_constructible_v<Engine, Args...>
+        explicit combining_tree(Args&&... args) : engine(std::forward<Args>(args)...) {}
+
+        combining_tree(const combining_tree&) = delete;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        combining_tree& operator=(const combining_tree&) = delete;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // Returns whether the value was inserted
+        bool insert(const_reference value) { return this->_publish(_Operation::insert, value); }
+
+        // Returns whether the value was erased
+        bool erase(const_reference value) { return this->_publish(_Operation::erase, value); }
+
+        [[nodiscard]] bool contains(const_reference value) { return this->_publish(_Operation::contains, value); }
+
+        // Calls `visitor(engine)` under the combiner lock, for operations that have no slot form (iteration, range
+        // queries, bulk updates); the engine must not escape the call
+        template<class Visitor>
+        decltype(auto) apply(Visitor visitor) {
+            std::lock_guard lock(this->mutex);
+            return visitor(this->engine);
+        }
+
+        [[nodiscard]] size_type size() {
+            return this->apply([](const Engine& engine) { return engine.size(); });
+        }
+
+    };
+
+} // adt
+
+
+#endif // COMBINING_TREE_HPP
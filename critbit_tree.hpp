@@ -0,0 +1,525 @@
+#ifndef CRITBIT_TREE_HPP
+#define CRITBIT_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <concepts>
+#include <bit>
+#include <compare>
+
+#include "binary_tree.hpp"
+#include "string_key.hpp"
+
+
+namespace adt {
+
+    /* -----------------------------------------------Crit-bit Traits----------------------------------------------- */
+    // Describes a key as a string of bits, most significant first, such that comparing the bit strings gives the
+    // same order as comparing the keys. `mismatch` returns the index of the first differing bit, or `npos`.
+    template<class T>
+    struct critbit_traits;
+
+    template<std::integral T>
+    struct critbit_traits<T> {
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using unsigned_type = std::make_unsigned_t<T>;
+
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        static constexpr std::size_t width = sizeof(T) * 8;
+
+        /* ----------------------------------------------Methods---------------------------------------------------- */
+        [[nodiscard]] static constexpr unsigned_type bits(const T& key) noexcept {
+            // Flip the sign bit so that negative values order before positive ones
+            if constexpr (std::is_signed_v<T>) {
+                return static_cast<unsigned_type>(key) ^ (unsigned_type(1) << (width - 1));
+            } else {
+                return key;
+            }
+        }
+
+        [[nodiscard]] static constexpr bool bit(const T& key, std::size_t index) noexcept {
+            return (bits(key) >> (width - 1 - index)) & 1;
+        }
+
+        [[nodiscard]] static constexpr std::size_t mismatch(const T& lhs, const T& rhs) noexcept {
+            const unsigned_type difference = bits(lhs) ^ bits(rhs);
+            return difference == 0 ? npos : static_cast<std::size_t>(std::countl_zero(difference));
+        }
+
+        [[nodiscard]] static constexpr std::size_t prefix_bits(const T&) noexcept { return width; }
+
+    };
+
+    // Strings are encoded as nine bits per byte: a "present" bit followed by the byte itself. The present bit makes
+    // a string order before every string it is a proper prefix of, which plain zero padding cannot express.
+    template<class T>
+    struct critbit_string_traits {
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        static constexpr std::size_t bits_per_byte = 9;
+
+        /* ----------------------------------------------Methods---------------------------------------------------- */
+        [[nodiscard]] static constexpr std::string_view view(const T& key) noexcept { return std::string_view(key); }
+
+        [[nodiscard]] static constexpr bool bit(const T& key, std::size_t index) noexcept {
+            const std::string_view text = view(key);
+            const std::size_t byte = index / bits_per_byte;
+            const std::size_t offset = index % bits_per_byte;
+
+            if (byte >= text.size()) {
+                return false;
+            }
+
+            if (offset == 0) {
+                return true;
+            }
+
+            return (static_cast<unsigned char>(text[byte]) >> (8 - offset)) & 1;
+        }
+
+        [[nodiscard]] static constexpr std::size_t mismatch(const T& lhs, const T& rhs) noexcept {
+            const std::string_view left = view(lhs);
+            const std::string_view right = view(rhs);
+            const std::size_t shortest = left.size() < right.size() ? left.size() : right.size();
+
+            for (std::size_t i = 0; i < shortest; ++i) {
+                const auto difference = static_cast<std::uint8_t>(left[i] ^ right[i]);
+                if (difference != 0) {
+                    return i * bits_per_byte + 1 + static_cast<std::size_t>(std::countl_zero(difference));
+                }
+            }
+
+            // One string is a prefix of the other, so they first differ in the next present bit
+            return left.size() == right.size() ? npos : shortest * bits_per_byte;
+        }
+
+        [[nodiscard]] static constexpr std::size_t prefix_bits(const T& prefix) noexcept {
+            return view(prefix).size() * bits_per_byte;
+        }
+
+    };
+
+    template<class CharTraits, class Allocator>
+    struct critbit_traits<std::basic_string<char, CharTraits, Allocator>>
+        : critbit_string_traits<std::basic_string<char, CharTraits, Allocator>> {};
+
+    template<>
+    struct critbit_traits<std::string_view> : critbit_string_traits<std::string_view> {};
+
+    template<>
+    struct critbit_traits<string_key> : critbit_string_traits<string_key> {};
+
+    /* -----------------------------------------------Crit-bit Index------------------------------------------------ */
+    // Per-node augmentation: the bit that internal nodes branch on. Leaves are the nodes without children.
+    struct critbit_index {
+        std::size_t bit = 0;
+
+        [[nodiscard]] constexpr bool operator==(const critbit_index&) const noexcept = default;
+
+        [[nodiscard]] constexpr auto operator<=>(const critbit_index&) const noexcept = default;
+    };
+
+    /* ------------------------------------------------Crit-bit Tree------------------------------------------------ */
+    // A PATRICIA (crit-bit) trie built from the binary tree's nodes. Internal nodes branch on one bit of the key and
+    // hold no key of their own, leaves hold the keys. Descending costs one bit test per level and no key
+    // comparisons; a single comparison against the leaf that is reached settles the lookup. Since the shape only
+    // depends on the set of keys, two trees holding the same keys are structurally identical.
+    template<class T, class Allocator = std::allocator<T>, class Traits = critbit_traits<T>>
+    class critbit_tree : public binary_tree<T, Allocator, critbit_index> {
+    private:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using base = binary_tree<T, Allocator, critbit_index>;
+
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::value_type;
+
+        using typename base::allocator_type;
+
+        using typename base::size_type;
+
+        using typename base::difference_type;
+
+        using typename base::reference;
+
+        using typename base::const_reference;
+
+        using traits_type = Traits;
+
+    protected:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::_Node;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] static constexpr bool _is_leaf(const _Node* node) noexcept { return node->left == nullptr; }
+
+        [[nodiscard]] static constexpr _Node* _child(const _Node* node, bool bit) noexcept {
+            return bit ? node->right : node->left;
+        }
+
+        [[nodiscard]] constexpr _Node* _closest_leaf(const_reference value) const noexcept {
+            // Follow the key's bits down to the only leaf that could hold it
+            _Node* node = this->root;
+            while (node != nullptr && !_is_leaf(node)) {
+                node = _child(node, traits_type::bit(value, node->augment.bit));
+            }
+
+            return node;
+        }
+
+        [[nodiscard]] static constexpr _Node* _first_leaf(_Node* node) noexcept {
+            while (node != nullptr && !_is_leaf(node)) {
+                node = node->left;
+            }
+
+            return node;
+        }
+
+        [[nodiscard]] static constexpr _Node* _last_leaf(_Node* node) noexcept {
+            while (node != nullptr && !_is_leaf(node)) {
+                node = node->right;
+            }
+
+            return node;
+        }
+
+        [[nodiscard]] static constexpr _Node* _next_leaf(_Node* node) noexcept {
+            // Climb until we leave a left subtree, then take the first leaf of the right one
+            _Node* parent = node->parent;
+            while (parent != nullptr && node == parent->right) {
+                node = parent;
+                parent = parent->parent;
+            }
+
+            return parent != nullptr ? _first_leaf(parent->right) : nullptr;
+        }
+
+        [[nodiscard]] static constexpr _Node* _previous_leaf(_Node* node) noexcept {
+            _Node* parent = node->parent;
+            while (parent != nullptr && node == parent->left) {
+                node = parent;
+                parent = parent->parent;
+            }
+
+            return parent != nullptr ? _last_leaf(parent->left) : nullptr;
+        }
+
+    public:
+        /* --------------------------------------------Constant Iterator-------------------------------------------- */
+        class const_iterator {
+        private:
+            /* --------------------------------------------Friends-------------------------------------------------- */
+            friend class critbit_tree;
+
+        protected:
+            /* ---------------------------------------------Fields-------------------------------------------------- */
+            const _Node* node;
+
+            const critbit_tree* tree;
+
+            /* ------------------------------------------Constructors----------------------------------------------- */
+            constexpr const_iterator(const _Node* node, const critbit_tree* tree) noexcept : node(node), tree(tree) {}
+
+        public:
+            /* -------------------------------------------Definitions----------------------------------------------- */
+            using iterator_category = std::bidirectional_iterator_tag;
+
+            using value_type = typename critbit_tree::value_type;
+
+            using difference_type = typename critbit_tree::difference_type;
+
+            using reference = const value_type&;
+
+            using pointer = const value_type*;
+
+            /* ------------------------------------------Constructors----------------------------------------------- */
+            constexpr const_iterator() noexcept : node(nullptr), tree(nullptr) {}
+
+            /* ---------------------------------------Overloaded Operators------------------------------------------ */
+            [[nodiscard]] constexpr bool operator==(const const_iterator& other) const noexcept {
+                return this->node == other.node;
+            }
+
+            [[nodiscard]] constexpr reference operator*() const noexcept { return this->node->value; }
+
+            [[nodiscard]] constexpr pointer operator->() const noexcept { return &(this->node->value); }
+
+            constexpr const_iterator& operator++() noexcept {
+                this->node = _next_leaf(const_cast<_Node*>(this->node));
+                return *this;
+            }
+
+            constexpr const_iterator operator++(int) noexcept {
+                const_iterator previous = *this;
+                ++(*this);
+                return previous;
+            }
+
+            constexpr const_iterator& operator--() noexcept {
+                // Decrementing `end()` lands on the largest key
+                this->node = this->node == nullptr ? _last_leaf(this->tree->root)
+                                                   : _previous_leaf(const_cast<_Node*>(this->node));
+                return *this;
+            }
+
+            constexpr const_iterator operator--(int) noexcept {
+                const_iterator previous = *this;
+                --(*this);
+                return previous;
+            }
+
+        };
+
+        using iterator = const_iterator;
+
+        using reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        constexpr critbit_tree() noexcept : base() {}
+
+        constexpr explicit critbit_tree(const allocator_type& allocator) noexcept : base(allocator) {}
+
+        constexpr critbit_tree(std::initializer_list<value_type> values, const allocator_type& allocator = allocator_type())
+            : base(allocator) {
+            this->insert(values);
+        }
+
+        constexpr critbit_tree(const critbit_tree&) = default;
+
+        constexpr critbit_tree(critbit_tree&&) noexcept = default;
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        constexpr ~critbit_tree() noexcept override = default;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        constexpr critbit_tree& operator=(const critbit_tree&) = default;
+
+        constexpr critbit_tree& operator=(critbit_tree&&) = default;
+
+        [[nodiscard]] constexpr bool operator==(const critbit_tree& other) const noexcept {
+            if (this->sz != other.sz) {
+                return false;
+            }
+
+            // Equal key sets give identical shapes, so comparing the leaves in order is enough
+            const _Node* lhs = _first_leaf(this->root);
+            const _Node* rhs = _first_leaf(other.root);
+            while (lhs != nullptr && rhs != nullptr) {
+                if (!(lhs->value == rhs->value)) {
+                    return false;
+                }
+
+                lhs = _next_leaf(const_cast<_Node*>(lhs));
+                rhs = _next_leaf(const_cast<_Node*>(rhs));
+            }
+
+            return lhs == rhs;
+        }
+
+        [[nodiscard]] constexpr std::compare_three_way_result_t<value_type>
+        operator<=>(const critbit_tree& other) const noexcept requires std::three_way_comparable<value_type> {
+            const _Node* lhs = _first_leaf(this->root);
+            const _Node* rhs = _first_leaf(other.root);
+            while (lhs != nullptr && rhs != nullptr) {
+                if (auto order = lhs->value <=> rhs->value; order != 0) {
+                    return order;
+                }
+
+                lhs = _next_leaf(const_cast<_Node*>(lhs));
+                rhs = _next_leaf(const_cast<_Node*>(rhs));
+            }
+
+            return this->sz <=> other.sz;
+        }
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] constexpr const_iterator begin() const noexcept { return {_first_leaf(this->root), this}; }
+
+        [[nodiscard]] constexpr const_iterator end() const noexcept { return {nullptr, this}; }
+
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return this->begin(); }
+
+        [[nodiscard]] constexpr const_iterator cend() const noexcept { return this->end(); }
+
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(this->end());
+        }
+
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(this->begin());
+        }
+
+        [[nodiscard]] constexpr const_reverse_iterator crbegin() const noexcept { return this->rbegin(); }
+
+        [[nodiscard]] constexpr const_reverse_iterator crend() const noexcept { return this->rend(); }
+
+        // Branch nodes hold placeholder keys and the nodes are not in search-tree order, so the base members that
+        // descend or walk the nodes by key order do not apply
+        constexpr void cache_lookups(size_type) = delete;
+
+        constexpr void index_top_levels(size_type) = delete;
+
+        constexpr void index_points(bool) = delete;
+
+        constexpr void absorb(std::span<typename base::binary_tree* const>) = delete;
+
+        constexpr void seek(const_iterator, const_reference) const = delete;
+
+        constexpr void clear() noexcept override {
+            this->_destroy_subtree(this->root);
+            this->root = nullptr;
+            this->sz = 0;
+            this->_record_reset();
+        }
+
+        constexpr void insert(std::initializer_list<value_type> values) noexcept override {
+            for (const_reference value : values) {
+                this->insert(value);
+            }
+        }
+
+        constexpr bool insert(const_reference value) noexcept {
+            if (this->root == nullptr) {
+                this->root = this->_construct_node(value);
+                ++this->sz;
+                this->_record(change_kind::insert, value);
+                return true;
+            }
+
+            // The new key branches off where it first differs from its closest existing key
+            const _Node* closest = this->_closest_leaf(value);
+            const std::size_t bit = traits_type::mismatch(value, closest->value);
+            if (bit == traits_type::npos) {
+                return false;
+            }
+
+            // Find the edge to split: the first node that branches on a later bit than `bit` (or a leaf)
+            _Node* parent = nullptr;
+            _Node* position = this->root;
+            while (!_is_leaf(position) && position->augment.bit < bit) {
+                parent = position;
+                position = _child(position, traits_type::bit(value, position->augment.bit));
+            }
+
+            _Node* leaf = this->_construct_node(value);
+            _Node* branch = this->_construct_node(value_type());
+            branch->augment.bit = bit;
+
+            this->_replace_child(parent, position, branch);
+            if (traits_type::bit(value, bit)) {
+                branch->left = position;
+                branch->right = leaf;
+            } else {
+                branch->left = leaf;
+                branch->right = position;
+            }
+            position->parent = branch;
+            leaf->parent = branch;
+
+            ++this->sz;
+            this->_record(change_kind::insert, value);
+
+            return true;
+        }
+
+        constexpr bool erase(const_reference value) noexcept {
+            _Node* leaf = this->_closest_leaf(value);
+            if (leaf == nullptr || !(leaf->value == value)) {
+                return false;
+            }
+
+            // The leaf's branch node becomes redundant, so its other child takes its place
+            _Node* branch = leaf->parent;
+            if (branch == nullptr) {
+                this->root = nullptr;
+            } else {
+                _Node* sibling = branch->left == leaf ? branch->right : branch->left;
+                this->_replace_child(branch->parent, branch, sibling);
+                this->_free_node(branch);
+            }
+            this->_free_node(leaf);
+
+            --this->sz;
+            this->_record(change_kind::erase, value);
+
+            return true;
+        }
+
+        [[nodiscard]] constexpr bool contains(const_reference value) const noexcept override {
+            const _Node* leaf = this->_closest_leaf(value);
+            return leaf != nullptr && leaf->value == value;
+        }
+
+        [[nodiscard]] constexpr const_iterator find(const_reference value) const noexcept {
+            const _Node* leaf = this->_closest_leaf(value);
+            return {leaf != nullptr && leaf->value == value ? leaf : nullptr, this};
+        }
+
+        // Looks up every key of `keys` and calls `visitor(key, position)` for each in order, where `position` is `end()`
+        // for absent keys. Lookups compare no keys on the way down, so unlike the base version nothing is shared.
+        template<class Visitor>
+        constexpr void find_sorted_batch(std::span<const value_type> keys, Visitor visitor) const {
+            for (const_reference key : keys) {
+                visitor(key, this->find(key));
+            }
+        }
+
+        // Calls `visitor(key)`, in order, for every key whose first `bits` bits match `prefix`. Descending to the
+        // subtree that holds them costs one bit test per level, after which every key visited is a match.
+        template<class Visitor>
+        constexpr void for_each_prefix(const_reference prefix, size_type bits, Visitor visitor) const {
+            _Node* node = this->root;
+            while (node != nullptr && !_is_leaf(node) && node->augment.bit < bits) {
+                node = _child(node, traits_type::bit(prefix, node->augment.bit));
+            }
+
+            if (node == nullptr) {
+                return;
+            }
+
+            // Every key below `node` agrees on the bits tested so far, so one check decides the whole subtree
+            const _Node* first = _first_leaf(node);
+            const std::size_t bit = traits_type::mismatch(prefix, first->value);
+            if (bit != traits_type::npos && bit < bits) {
+                return;
+            }
+
+            const _Node* last = _last_leaf(node);
+            for (const _Node* leaf = first; ; leaf = _next_leaf(const_cast<_Node*>(leaf))) {
+                visitor(leaf->value);
+                if (leaf == last) {
+                    break;
+                }
+            }
+        }
+
+        template<class Visitor>
+        constexpr void for_each_prefix(const_reference prefix, Visitor visitor) const {
+            this->for_each_prefix(prefix, traits_type::prefix_bits(prefix), visitor);
+        }
+
+    };
+
+    namespace pmr {
+
+        template<class T, class Traits = critbit_traits<T>>
+        using critbit_tree = adt::critbit_tree<T, std::pmr::polymorphic_allocator<T>, Traits>;
+
+    } // pmr
+
+} // adt
+
+
+#endif // CRITBIT_TREE_HPP
@@ -0,0 +1,86 @@
+#ifndef EYTZINGER_HPP
+#define EYTZINGER_HPP
+
+#include <cstddef>
+#include <span>
+#include <bit>
+#include <algorithm>
+
+
+namespace adt {
+
+    // Helpers for the Eytzinger (BFS) layout of a sorted array: position k holds the root of an implicit binary
+    // search tree whose children sit at 2k and 2k + 1. Positions are 1-based, stored at index k - 1, and 0 means
+    // "none". The top levels of the search share a handful of cache lines, and each step of a search can prefetch
+    // the line holding its great-great-grandchildren, which a binary search over a sorted array cannot.
+    namespace eytzinger {
+
+        // Position of the smallest value
+        [[nodiscard]] constexpr std::size_t first(std::size_t count) noexcept {
+            if (count == 0) {
+                return 0;
+            }
+
+            std::size_t position = 1;
+            while (2 * position <= count) {
+                position *= 2;
+            }
+
+            return position;
+        }
+
+        // Position of the next larger value after `position`, or 0 past the largest
+        [[nodiscard]] constexpr std::size_t next(std::size_t position, std::size_t count) noexcept {
+            if (2 * position + 1 <= count) {
+                position = 2 * position + 1;
+                while (2 * position <= count) {
+                    position *= 2;
+                }
+                return position;
+            }
+
+            // Climb while we are a right child, then once more to the parent we are the left child of
+            while (position & 1) {
+                position >>= 1;
+            }
+
+            return position >> 1;
+        }
+
+        // Permutes `sorted` into Eytzinger order in `out`, which must have the same size
+        template<class T>
+        constexpr void layout(std::span<const T> sorted, std::span<T> out) {
+            std::size_t index = 0;
+            for (std::size_t position = first(out.size()); position != 0; position = next(position, out.size())) {
+                out[position - 1] = sorted[index++];
+            }
+        }
+
+        // Position of the first value `>= value` (or `> value` when `strict`), or 0 if there is none
+        template<class T>
+        [[nodiscard]] constexpr std::size_t lower_bound(std::span<const T> data,
+                                                        const T& value,
+                                                        bool strict = false) noexcept {
+            const std::size_t count = data.size();
+
+            std::size_t position = 1;
+            while (position <= count) {
+                if !consteval {
+                    // Sixteen positions further down is the first great-great-grandchild, four levels ahead
+                    __builtin_prefetch(data.data() + std::min(16 * position, count) - 1);
+                }
+
+                const bool right = strict ? !(value < data[position - 1]) : data[position - 1] < value;
+                position = 2 * position + right;
+            }
+
+            // Undo the trailing right turns, and the last left turn, to land on the last node we went left at
+            return position >> (std::countr_one(position) + 1);
+        }
+
+    } // eytzinger
+
+} // adt
+
+
+#endif // EYTZINGER_HPP
@@ -0,0 +1,88 @@
+#ifndef INDEXED_TREE_HPP
+#define INDEXED_TREE_HPP
+
+#include <memory>
+#include <memory_resource>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+
+#include "avl_tree.hpp"
+
+
+namespace adt {
+
+    /* ------------------------------------------------Indexed Tree------------------------------------------------- */
+    // An AVL tree with its point index always on: `contains`, `find` and erasing by value go through a hash table
+    // of the nodes in O(1) expected time, while iteration and range queries (`lower_bound`, `upper_bound`, views)
+    // use the tree. Both are updated within the same insertion or erasure.
+    template<class T, class Allocator = std::allocator<T>, class Augment = no_augment>
+        requires hashable<T>
+    class indexed_tree : public avl_tree<T, Allocator, Augment> {
+    private:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using base = avl_tree<T, Allocator, Augment>;
+
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::value_type;
+
+        using typename base::allocator_type;
+
+        using typename base::size_type;
+
+        using typename base::difference_type;
+
+        using typename base::reference;
+
+        using typename base::const_reference;
+
+        using typename base::iterator;
+
+        using typename base::const_iterator;
+
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        indexed_tree() : base() { this->index_points(true); }
+
+        explicit indexed_tree(const allocator_type& allocator) : base(allocator) { this->index_points(true); }
+
+        indexed_tree(std::initializer_list<value_type> values, const allocator_type& allocator = allocator_type())
+            : base(allocator) {
+            this->index_points(true);
+            this->insert(values);
+        }
+
+        template<std::input_iterator InputIterator>
+        indexed_tree(InputIterator first, InputIterator last, const allocator_type& allocator = allocator_type())
+            : base(allocator) {
+            this->index_points(true);
+            std::vector<value_type> values(first, last);
+            this->_assign_unsorted(values);
+        }
+
+        indexed_tree(const indexed_tree& other) : base(other) { this->index_points(true); }
+
+        // The index travels with the nodes, so moving costs no rehashing; the moved-from tree falls back to descents
+        indexed_tree(indexed_tree&&) noexcept = default;
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~indexed_tree() noexcept override = default;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        indexed_tree& operator=(const indexed_tree&) = default;
+
+        indexed_tree& operator=(indexed_tree&&) = default;
+
+    };
+
+    namespace pmr {
+
+        template<class T, class Augment = no_augment>
+        using indexed_tree = adt::indexed_tree<T, std::pmr::polymorphic_allocator<T>, Augment>;
+
+    } // pmr
+
+} // adt
+
+
+#endif // INDEXED_TREE_HPP
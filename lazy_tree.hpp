@@ -0,0 +1,227 @@
+#ifndef LAZY_TREE_HPP
+#define LAZY_TREE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <span>
+
+#include "avl_tree.hpp"
+
+
+namespace adt {
+
+    /* --------------------------------------------------Tombstone-------------------------------------------------- */
+    // Plain node data (not derived from the subtree): whether the node's value was erased. The base tree steps over
+    // such nodes in searches and iteration.
+    struct tombstone {
+        /* ----------------------------------------------Fields----------------------------------------------------- */
+        bool dead = false;
+
+        [[nodiscard]] constexpr bool operator==(const tombstone&) const noexcept = default;
+
+    };
+
+    /* --------------------------------------------------Lazy Tree-------------------------------------------------- */
+    // An AVL tree whose erasures only mark the node as dead, with no unlinking or rebalancing. Once dead nodes
+    // outnumber live ones, a purge frees them all and relinks the survivors as a perfectly balanced tree in one
+    // linear pass, so the amortized cost of an erase is a search plus O(1). Inserting a value whose node is dead
+    // revives the node in place. `size()` counts live values only.
+    template<class T, class Allocator = std::allocator<T>>
+    class lazy_tree : public avl_tree<T, Allocator, tombstone> {
+    private:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using base = avl_tree<T, Allocator, tombstone>;
+
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::value_type;
+
+        using typename base::allocator_type;
+
+        using typename base::size_type;
+
+        using typename base::difference_type;
+
+        using typename base::reference;
+
+        using typename base::const_reference;
+
+        using typename base::iterator;
+
+        using typename base::const_iterator;
+
+    protected:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::_Node;
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        size_type dead_count = 0;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        void _bury(_Node* node) {
+            this->_record(change_kind::erase, node->value);
+            node->augment.dead = true;
+            --this->sz;
+            ++this->dead_count;
+
+            if (this->dead_count > this->sz) {
+                this->purge();
+            }
+        }
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        lazy_tree() noexcept : base() {}
+
+        explicit lazy_tree(const allocator_type& allocator) noexcept : base(allocator) {}
+
+        lazy_tree(std::initializer_list<value_type> values, const allocator_type& allocator = allocator_type())
+            : base(allocator) {
+            this->insert(values);
+        }
+
+        template<std::input_iterator InputIterator>
+        lazy_tree(InputIterator first, InputIterator last, const allocator_type& allocator = allocator_type())
+            : base(first, last, allocator) {}
+
+        // Copies carry the dead nodes along, so the count stays accurate
+        lazy_tree(const lazy_tree&) = default;
+
+        lazy_tree(lazy_tree&& other) noexcept
+            : base(std::move(other)), dead_count(std::exchange(other.dead_count, 0)) {}
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~lazy_tree() noexcept override = default;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        lazy_tree& operator=(const lazy_tree&) = default;
+
+        // When the base copies the nodes rather than taking them, the source keeps its dead nodes and their count
+        lazy_tree& operator=(lazy_tree&& other)
+            noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                     std::allocator_traits<Allocator>::is_always_equal::value) {
+            if (this == &other) {
+                return *this;
+            }
+
+            const bool stolen = std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                                this->get_allocator() == other.get_allocator();
+            base::operator=(std::move(other));
+            this->dead_count = stolen ? std::exchange(other.dead_count, 0) : other.dead_count;
+            return *this;
+        }
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // Dead nodes still linked into the tree
+        [[nodiscard]] size_type tombstones() const noexcept { return this->dead_count; }
+
+        void clear() noexcept override {
+            base::clear();
+            this->dead_count = 0;
+        }
+
+        void insert(std::initializer_list<value_type> values) noexcept override {
+            for (const_reference value : values) {
+                this->insert(value);
+            }
+        }
+
+        std::pair<iterator, bool> insert(const_reference value) noexcept {
+            auto [position, inserted] = base::insert(value);
+
+            _Node* node = base::_node_of(position);
+            if (!inserted && node->augment.dead) {
+                node->augment.dead = false;
+                ++this->sz;
+                --this->dead_count;
+                this->_record(change_kind::insert, value);
+                inserted = true;
+            }
+
+            return {position, inserted};
+        }
+
+        size_type erase(const_reference value) {
+            _Node* node = this->_find_node(value);
+            if (node == nullptr) {
+                return 0;
+            }
+
+            this->_bury(node);
+
+            return 1;
+        }
+
+        // The returned iterator stays valid across the purge this erase may trigger, since purging relinks nodes
+        // without moving them
+        iterator erase(const_iterator position) {
+            _Node* node = base::_node_of(position);
+            _Node* next = base::_next(node);
+
+            this->_bury(node);
+
+            return base::_iterator_at(next);
+        }
+
+        // Frees every dead node and relinks the live ones as a perfectly balanced tree, in O(n)
+        void purge() {
+            if (this->dead_count == 0) {
+                return;
+            }
+
+            std::vector<_Node*> live;
+            std::vector<_Node*> dead;
+            live.reserve(this->sz);
+            dead.reserve(this->dead_count);
+            for (_Node* node = base::_leftmost(this->root); node != nullptr; node = base::_successor(node)) {
+                (node->augment.dead ? dead : live).push_back(node);
+            }
+
+            // The walk follows the old links, so nothing is freed until it is done
+            for (_Node* node : dead) {
+                this->_free_node(node);
+            }
+            this->root = this->_link_balanced(live, nullptr);
+            this->dead_count = 0;
+
+            // The values are unchanged, so only the directory, which mirrors the shape, needs a rebuild
+            this->stale = !this->directory.empty();
+        }
+
+        void swap(lazy_tree& other) noexcept {
+            base::swap(other);
+            std::swap(this->dead_count, other.dead_count);
+        }
+
+        friend void swap(lazy_tree& lhs, lazy_tree& rhs) noexcept { lhs.swap(rhs); }
+
+        // Absorbing drops dead nodes like duplicates, so neither this tree nor any lazy source has any left
+        void absorb(std::span<typename base::binary_tree* const> sources) {
+            base::absorb(sources);
+
+            this->dead_count = 0;
+            for (typename base::binary_tree* source : sources) {
+                if (auto* lazy = dynamic_cast<lazy_tree*>(source); lazy != nullptr) {
+                    lazy->dead_count = 0;
+                }
+            }
+        }
+
+    };
+
+    namespace pmr {
+
+        template<class T>
+        using lazy_tree = adt::lazy_tree<T, std::pmr::polymorphic_allocator<T>>;
+
+    } // pmr
+
+} // adt
+
+
+#endif // LAZY_TREE_HPP
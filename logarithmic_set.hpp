@@ -0,0 +1,488 @@
+#ifndef LOGARITHMIC_SET_HPP
+#define LOGARITHMIC_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <bit>
+
+#include "eytzinger.hpp"
+
+
+namespace adt {
+
+    /* ----------------------------------------------Logarithmic Set------------------------------------------------ */
+    // An ordered set kept as O(log n) immutable levels (Bentley and Saxe's logarithmic method). Level i holds at most
+    // 2^i values in Eytzinger order. An insertion merges the full low levels into the first one with room, like a
+    // carry through a binary counter, so each value is moved O(log n) times in sequential passes, and lookups
+    // search contiguous arrays. Erasure only marks the value dead in its level; dead values are dropped by the next
+    // merge that reaches them, or all at once when they outnumber the live ones.
+    template<class T, class Allocator = std::allocator<T>>
+    class logarithmic_set {
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using value_type = T;
+
+        using key_type = T;
+
+        using allocator_type = Allocator;
+
+        using size_type = std::size_t;
+
+        using difference_type = std::ptrdiff_t;
+
+        using reference = value_type&;
+
+        using const_reference = const value_type&;
+
+    protected:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using allocator_traits = std::allocator_traits<allocator_type>;
+
+        using _WordAllocator = typename allocator_traits::template rebind_alloc<std::uint64_t>;
+
+        using _Values = std::vector<value_type, allocator_type>;
+
+        /* -------------------------------------------------Level--------------------------------------------------- */
+        struct _Level {
+            /* --------------------------------------------Fields--------------------------------------------------- */
+            // Eytzinger order; empty when the level is unused
+            _Values keys;
+
+            // One bit per position of `keys`, set once the value there has been erased
+            std::vector<std::uint64_t, _WordAllocator> erased;
+
+            size_type dead = 0;
+
+            /* ------------------------------------------Constructors----------------------------------------------- */
+            explicit _Level(const allocator_type& allocator) : keys(allocator), erased(_WordAllocator(allocator)) {}
+
+            /* --------------------------------------------Methods-------------------------------------------------- */
+            [[nodiscard]] bool is_erased(std::size_t position) const noexcept {
+                return (this->erased[(position - 1) / 64] >> ((position - 1) % 64)) & 1;
+            }
+
+            // First live position at or after `position`
+            [[nodiscard]] std::size_t skip_erased(std::size_t position) const noexcept {
+                if (this->dead != 0) {
+                    while (position != 0 && this->is_erased(position)) {
+                        position = eytzinger::next(position, this->keys.size());
+                    }
+                }
+
+                return position;
+            }
+        };
+
+        using _LevelAllocator = typename allocator_traits::template rebind_alloc<_Level>;
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        std::vector<_Level, _LevelAllocator> levels;
+
+        allocator_type allocator;
+
+        size_type sz;
+
+        size_type dead;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // Level and position holding `value`, dead or alive, or position 0 if no level does. Each value is held by at
+        // most one level, since inserting a dead value revives it in place.
+        [[nodiscard]] std::pair<std::size_t, std::size_t> _locate(const_reference value) const noexcept {
+            for (std::size_t level = 0; level < this->levels.size(); ++level) {
+                const _Values& keys = this->levels[level].keys;
+                const std::size_t position = eytzinger::lower_bound<value_type>(keys, value);
+                if (position != 0 && !(value < keys[position - 1])) {
+                    return {level, position};
+                }
+            }
+
+            return {0, 0};
+        }
+
+        // Copies the levels of `other` into this set's allocator, which holds none yet
+        void _clone_levels(const logarithmic_set& other) {
+            this->levels.reserve(other.levels.size());
+            for (const _Level& level : other.levels) {
+                _Level& copy = this->levels.emplace_back(this->allocator);
+                copy.keys.assign(level.keys.begin(), level.keys.end());
+                copy.erased.assign(level.erased.begin(), level.erased.end());
+                copy.dead = level.dead;
+            }
+            this->sz = other.sz;
+            this->dead = other.dead;
+        }
+
+        // Moves the live values of `level` to the end of `out`, in ascending order
+        static void _collect(_Level& level, _Values& out) {
+            const std::size_t count = level.keys.size();
+            for (std::size_t position = eytzinger::first(count); position != 0;
+                 position = eytzinger::next(position, count)) {
+                if (level.dead == 0 || !level.is_erased(position)) {
+                    out.push_back(std::move(level.keys[position - 1]));
+                }
+            }
+        }
+
+        // Merges the live values of `level` into `carry`, then empties `level`
+        void _absorb(_Level& level, _Values& carry) {
+            _Values values(this->allocator);
+            values.reserve(level.keys.size() - level.dead);
+            _collect(level, values);
+
+            _Values merged(this->allocator);
+            merged.reserve(values.size() + carry.size());
+            std::merge(std::make_move_iterator(values.begin()),
+                       std::make_move_iterator(values.end()),
+                       std::make_move_iterator(carry.begin()),
+                       std::make_move_iterator(carry.end()),
+                       std::back_inserter(merged));
+            carry = std::move(merged);
+
+            this->dead -= level.dead;
+            level = _Level(this->allocator);
+        }
+
+        void _place(_Values& sorted, std::size_t index) {
+            while (this->levels.size() <= index) {
+                this->levels.emplace_back(this->allocator);
+            }
+
+            _Level& level = this->levels[index];
+            level.keys.assign(sorted.size(), value_type());
+            eytzinger::layout<value_type>(sorted, level.keys);
+            level.erased.assign((sorted.size() + 63) / 64, 0);
+            level.dead = 0;
+        }
+
+        void _compact() {
+            // Rebuild everything as one level; merging the smallest levels first keeps the total work linear
+            _Values carry(this->allocator);
+            for (_Level& level : this->levels) {
+                if (!level.keys.empty()) {
+                    this->_absorb(level, carry);
+                }
+            }
+
+            this->levels.clear();
+            if (!carry.empty()) {
+                this->_place(carry, std::bit_width(carry.size() - 1));
+            }
+        }
+
+    public:
+        /* --------------------------------------------Constant Iterator-------------------------------------------- */
+        // Merges the levels on the fly: one cursor per level, always standing on the smallest cursor's value
+        class const_iterator {
+        private:
+            /* --------------------------------------------Friends-------------------------------------------------- */
+            friend class logarithmic_set;
+
+        protected:
+            /* ---------------------------------------------Fields-------------------------------------------------- */
+            const logarithmic_set* set;
+
+            std::vector<std::size_t> cursors;
+
+            std::size_t current;
+
+            /* ------------------------------------------Constructors----------------------------------------------- */
+            const_iterator(const logarithmic_set* set, std::vector<std::size_t> cursors)
+                : set(set), cursors(std::move(cursors)), current(npos) {
+                this->_pick();
+            }
+
+            /* --------------------------------------------Methods-------------------------------------------------- */
+            static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+            [[nodiscard]] const typename logarithmic_set::value_type& _at(std::size_t level) const noexcept {
+                return this->set->levels[level].keys[this->cursors[level] - 1];
+            }
+
+            void _pick() noexcept {
+                this->current = npos;
+                for (std::size_t level = 0; level < this->cursors.size(); ++level) {
+                    if (this->cursors[level] == 0) {
+                        continue;
+                    }
+
+                    if (this->current == npos || this->_at(level) < this->_at(this->current)) {
+                        this->current = level;
+                    }
+                }
+            }
+
+        public:
+            /* -------------------------------------------Definitions----------------------------------------------- */
+            using iterator_category = std::forward_iterator_tag;
+
+            using value_type = typename logarithmic_set::value_type;
+
+            using difference_type = typename logarithmic_set::difference_type;
+
+            using reference = const value_type&;
+
+            using pointer = const value_type*;
+
+            /* ------------------------------------------Constructors----------------------------------------------- */
+            const_iterator() noexcept : set(nullptr), current(npos) {}
+
+            /* ---------------------------------------Overloaded Operators------------------------------------------ */
+            [[nodiscard]] bool operator==(const const_iterator& other) const noexcept {
+                if (this->current == npos || other.current == npos) {
+                    return this->current == other.current;
+                }
+
+                return this->current == other.current && this->cursors[this->current] == other.cursors[other.current];
+            }
+
+            [[nodiscard]] reference operator*() const noexcept { return this->_at(this->current); }
+
+            [[nodiscard]] pointer operator->() const noexcept { return &this->_at(this->current); }
+
+            const_iterator& operator++() noexcept {
+                const _Level& level = this->set->levels[this->current];
+                this->cursors[this->current] =
+                    level.skip_erased(eytzinger::next(this->cursors[this->current], level.keys.size()));
+                this->_pick();
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator previous = *this;
+                ++(*this);
+                return previous;
+            }
+
+        };
+
+        using iterator = const_iterator;
+
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        logarithmic_set() : logarithmic_set(allocator_type()) {}
+
+        explicit logarithmic_set(const allocator_type& allocator)
+            : levels(_LevelAllocator(allocator)), allocator(allocator), sz(0), dead(0) {}
+
+        logarithmic_set(std::initializer_list<value_type> values, const allocator_type& allocator = allocator_type())
+            : logarithmic_set(allocator) {
+            this->insert(values);
+        }
+
+        logarithmic_set(const logarithmic_set& other)
+            : levels(other.levels,
+                     _LevelAllocator(allocator_traits::select_on_container_copy_construction(other.allocator))),
+              allocator(allocator_traits::select_on_container_copy_construction(other.allocator)),
+              sz(other.sz),
+              dead(other.dead) {}
+
+        logarithmic_set(logarithmic_set&& other) noexcept
+            : levels(std::move(other.levels)),
+              allocator(std::move(other.allocator)),
+              sz(std::exchange(other.sz, 0)),
+              dead(std::exchange(other.dead, 0)) {}
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~logarithmic_set() noexcept = default;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        logarithmic_set& operator=(const logarithmic_set& other) {
+            if (this == &other) {
+                return *this;
+            }
+
+            this->clear();
+            if constexpr (allocator_traits::propagate_on_container_copy_assignment::value) {
+                this->allocator = other.allocator;
+                this->levels = std::vector<_Level, _LevelAllocator>(_LevelAllocator(this->allocator));
+            }
+
+            this->_clone_levels(other);
+
+            return *this;
+        }
+
+        logarithmic_set& operator=(logarithmic_set&& other)
+            noexcept(allocator_traits::propagate_on_container_move_assignment::value ||
+                     allocator_traits::is_always_equal::value) {
+            if (this == &other) {
+                return *this;
+            }
+
+            this->clear();
+            if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+                // Take over the allocator along with the levels it owns
+                this->allocator = std::move(other.allocator);
+                this->levels = std::move(other.levels);
+            } else if (this->allocator == other.allocator) {
+                this->levels = std::move(other.levels);
+            } else {
+                // The allocators differ and may not propagate, so copy the levels into our own allocator
+                this->_clone_levels(other);
+                return *this;
+            }
+
+            other.levels.clear();
+            this->sz = std::exchange(other.sz, 0);
+            this->dead = std::exchange(other.dead, 0);
+
+            return *this;
+        }
+
+        [[nodiscard]] bool operator==(const logarithmic_set& other) const {
+            return this->sz == other.sz && std::equal(this->begin(), this->end(), other.begin());
+        }
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] size_type size() const noexcept { return this->sz; }
+
+        [[nodiscard]] bool empty() const noexcept { return this->sz == 0; }
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept { return this->allocator; }
+
+        // Number of levels in use, at most one more than log2 of the number of values held (dead ones included)
+        [[nodiscard]] size_type levels_in_use() const noexcept {
+            return static_cast<size_type>(std::ranges::count_if(this->levels, [](const _Level& level) {
+                return !level.keys.empty();
+            }));
+        }
+
+        [[nodiscard]] const_iterator begin() const {
+            std::vector<std::size_t> cursors(this->levels.size());
+            for (std::size_t level = 0; level < this->levels.size(); ++level) {
+                const _Level& current = this->levels[level];
+                cursors[level] = current.skip_erased(eytzinger::first(current.keys.size()));
+            }
+
+            return const_iterator(this, std::move(cursors));
+        }
+
+        [[nodiscard]] const_iterator end() const noexcept { return const_iterator(); }
+
+        [[nodiscard]] const_iterator cbegin() const { return this->begin(); }
+
+        [[nodiscard]] const_iterator cend() const noexcept { return this->end(); }
+
+        void swap(logarithmic_set& other) noexcept {
+            using std::swap;
+            if constexpr (allocator_traits::propagate_on_container_swap::value) {
+                swap(this->allocator, other.allocator);
+            }
+            swap(this->levels, other.levels);
+            swap(this->sz, other.sz);
+            swap(this->dead, other.dead);
+        }
+
+        friend void swap(logarithmic_set& lhs, logarithmic_set& rhs) noexcept { lhs.swap(rhs); }
+
+        void clear() noexcept {
+            this->levels.clear();
+            this->sz = 0;
+            this->dead = 0;
+        }
+
+        void insert(std::initializer_list<value_type> values) {
+            for (const_reference value : values) {
+                this->insert(value);
+            }
+        }
+
+        bool insert(const_reference value) {
+            if (const auto [index, position] = this->_locate(value); position != 0) {
+                _Level& level = this->levels[index];
+                if (!level.is_erased(position)) {
+                    return false;
+                }
+
+                // Revive the dead copy rather than adding a second one
+                level.erased[(position - 1) / 64] &= ~(std::uint64_t(1) << ((position - 1) % 64));
+                --level.dead;
+                --this->dead;
+                ++this->sz;
+                return true;
+            }
+
+            // Carry the new value up through the levels until one has room for everything below it
+            _Values carry(1, value, this->allocator);
+            std::size_t index = 0;
+            for (; index < this->levels.size(); ++index) {
+                _Level& level = this->levels[index];
+                if (!level.keys.empty()) {
+                    this->_absorb(level, carry);
+                }
+
+                if (carry.size() <= (std::size_t(1) << index)) {
+                    break;
+                }
+            }
+
+            this->_place(carry, index);
+            ++this->sz;
+            return true;
+        }
+
+        size_type erase(const_reference value) {
+            const auto [index, position] = this->_locate(value);
+            if (position == 0) {
+                return 0;
+            }
+
+            _Level& level = this->levels[index];
+            if (level.is_erased(position)) {
+                return 0;
+            }
+
+            level.erased[(position - 1) / 64] |= std::uint64_t(1) << ((position - 1) % 64);
+            ++level.dead;
+            ++this->dead;
+            --this->sz;
+
+            if (this->dead > this->sz) {
+                this->_compact();
+            }
+
+            return 1;
+        }
+
+        [[nodiscard]] bool contains(const_reference value) const noexcept {
+            const auto [index, position] = this->_locate(value);
+            return position != 0 && !this->levels[index].is_erased(position);
+        }
+
+        // First value `>= value`
+        [[nodiscard]] const_iterator lower_bound(const_reference value) const {
+            std::vector<std::size_t> cursors(this->levels.size());
+            for (std::size_t level = 0; level < this->levels.size(); ++level) {
+                const _Level& current = this->levels[level];
+                cursors[level] = current.skip_erased(eytzinger::lower_bound<value_type>(current.keys, value));
+            }
+
+            return const_iterator(this, std::move(cursors));
+        }
+
+        [[nodiscard]] const_iterator find(const_reference value) const {
+            const const_iterator position = this->lower_bound(value);
+            return position != this->end() && !(value < *position) ? position : this->end();
+        }
+
+    };
+
+    namespace pmr {
+
+        template<class T>
+        using logarithmic_set = adt::logarithmic_set<T, std::pmr::polymorphic_allocator<T>>;
+
+    } // pmr
+
+} // adt
+
+
+#endif // LOGARITHMIC_SET_HPP
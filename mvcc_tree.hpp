@@ -0,0 +1,433 @@
+#ifndef MVCC_TREE_HPP
+#define MVCC_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+#include <deque>
+#include <map>
+#include <span>
+#include <algorithm>
+#include <limits>
+
+#include "avl_tree.hpp"
+
+
+namespace adt {
+
+    /* ------------------------------------------------Version Stamp------------------------------------------------- */
+    // Plain node data (not derived from the subtree): the timestamps between which the node's value was present.
+    // The current interval starts at `begin` and, once `dead`, ends before `end`; intervals from earlier lives of
+    // the same value that a snapshot may still read are kept in `history`, oldest first. `dead` doubles as the
+    // tombstone the base tree steps over, so the present is read like any other tree. `retired` counts the node's
+    // entries in its tree's queue of closed versions awaiting reclamation.
+    struct version_stamp {
+        /* ----------------------------------------------Fields----------------------------------------------------- */
+        std::uint64_t begin = 0;
+
+        std::uint64_t end = 0;
+
+        bool dead = false;
+
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> history;
+
+        std::size_t retired = 0;
+
+        /* ----------------------------------------------Methods---------------------------------------------------- */
+        [[nodiscard]] constexpr bool visible_at(std::uint64_t stamp) const noexcept {
+            if (this->begin <= stamp && (!this->dead || stamp < this->end)) {
+                return true;
+            }
+
+            return std::ranges::any_of(this->history, [stamp](const auto& interval) {
+                return interval.first <= stamp && stamp < interval.second;
+            });
+        }
+
+        [[nodiscard]] bool operator==(const version_stamp&) const noexcept = default;
+
+    };
+
+    /* --------------------------------------------------MVCC Tree-------------------------------------------------- */
+    // A multi-version AVL tree: every write takes the next timestamp, and erasing a value only closes its node's
+    // interval. A `snapshot_view` pins the timestamp it was taken at and reads exactly the values present then, so a
+    // long range scan sees one consistent state while writes carry on between its steps, with no copy of the tree.
+    // Nodes are not moved by rebalancing and not freed while any open snapshot can see them, so a scan in progress
+    // stays valid. A closed version no open snapshot can see is freed as it closes; one that some snapshot can see
+    // is queued, in order of closing, and freed once every snapshot taken before it closed has been released, so
+    // each write costs O(log n) amortized. `collect()` frees everything unreachable at once, in O(n log n). Reads of
+    // the present (`contains`, `find`, iteration) ignore closed versions.
+    //
+    // Snapshots refer to their tree and must be released before it is destroyed. Like the other engines, the tree
+    // does no locking: writes and snapshot reads interleave on one thread, or under the caller's lock.
+    template<class T, class Allocator = std::allocator<T>>
+    class mvcc_tree : public avl_tree<T, Allocator, version_stamp> {
+    private:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using base = avl_tree<T, Allocator, version_stamp>;
+
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::value_type;
+
+        using typename base::allocator_type;
+
+        using typename base::size_type;
+
+        using typename base::difference_type;
+
+        using typename base::reference;
+
+        using typename base::const_reference;
+
+        using typename base::iterator;
+
+        using typename base::const_iterator;
+
+        class snapshot_view;
+
+    protected:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::_Node;
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        // Timestamp of the latest write
+        std::uint64_t clock = 0;
+
+        size_type dead_count = 0;
+
+        // Timestamps of the open snapshots, with how many are open at each
+        std::map<std::uint64_t, size_type> snapshots;
+
+        // Intervals some open snapshot could read when they closed, as (end, node), in order of `end`. An entry may
+        // outlive its interval, when the node was revived while nothing could read it any more.
+        std::deque<std::pair<std::uint64_t, _Node*>> retired;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // Whether some open snapshot was taken within [begin, end)
+        [[nodiscard]] bool _pinned(std::uint64_t begin, std::uint64_t end) const noexcept {
+            const auto snapshot = this->snapshots.lower_bound(begin);
+            return snapshot != this->snapshots.end() && snapshot->first < end;
+        }
+
+        // First node, of any version, whose value is `>= value`
+        [[nodiscard]] _Node* _lower_bound_version(const_reference value) const noexcept {
+            _Node* node = this->root;
+            _Node* bound = nullptr;
+            while (node != nullptr) {
+                if (!(node->value < value)) {
+                    bound = node;
+                    node = node->left;
+                } else {
+                    node = node->right;
+                }
+            }
+
+            return bound;
+        }
+
+        void _reclaim(_Node* node) noexcept {
+            // `_erase_node` takes the node off the live count, which closing it already did
+            ++this->sz;
+            this->_erase_node(node);
+            --this->dead_count;
+        }
+
+        // Frees `node` if it is dead and no version of it can be read or is still queued. Unlinking rebalances, which
+        // a scan in progress tolerates, since no node it can reach is freed.
+        void _reclaim_if_unreachable(_Node* node) noexcept {
+            const version_stamp& stamp = node->augment;
+            if (stamp.dead && stamp.history.empty() && stamp.retired == 0 && !this->_pinned(stamp.begin, stamp.end)) {
+                this->_reclaim(node);
+            }
+        }
+
+        // The node's current interval has just closed. Snapshots are only ever taken of the present, so the set of
+        // snapshots that can read a closed interval only shrinks: if none can now, none ever will.
+        void _retire(_Node* node) {
+            if (this->_pinned(node->augment.begin, node->augment.end)) {
+                this->retired.emplace_back(node->augment.end, node);
+                ++node->augment.retired;
+            } else {
+                this->_reclaim_if_unreachable(node);
+            }
+        }
+
+        void _close(_Node* node) {
+            node->augment.end = ++this->clock;
+            node->augment.dead = true;
+            --this->sz;
+            ++this->dead_count;
+            this->_record(change_kind::erase, node->value);
+            this->_retire(node);
+        }
+
+        void _release(std::uint64_t stamp) {
+            const auto snapshot = this->snapshots.find(stamp);
+            if (--snapshot->second == 0) {
+                this->snapshots.erase(snapshot);
+            }
+
+            // Every open snapshot is at least as new as the oldest, so no interval that ended by then can be read
+            const std::uint64_t oldest =
+                this->snapshots.empty() ? std::numeric_limits<std::uint64_t>::max() : this->snapshots.begin()->first;
+            while (!this->retired.empty() && this->retired.front().first <= oldest) {
+                const auto [end, node] = this->retired.front();
+                this->retired.pop_front();
+
+                std::erase_if(node->augment.history, [end](const auto& interval) { return interval.second == end; });
+                --node->augment.retired;
+                this->_reclaim_if_unreachable(node);
+            }
+        }
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        mvcc_tree() noexcept : base() {}
+
+        explicit mvcc_tree(const allocator_type& allocator) noexcept : base(allocator) {}
+
+        mvcc_tree(std::initializer_list<value_type> values, const allocator_type& allocator = allocator_type())
+            : base(allocator) {
+            this->insert(values);
+        }
+
+        // Open snapshots point at the tree, so it stays where it is
+        mvcc_tree(const mvcc_tree&) = delete;
+
+        mvcc_tree(mvcc_tree&&) = delete;
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~mvcc_tree() noexcept override = default;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        mvcc_tree& operator=(const mvcc_tree&) = delete;
+
+        mvcc_tree& operator=(mvcc_tree&&) = delete;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] std::uint64_t timestamp() const noexcept { return this->clock; }
+
+        // Live values and closed versions still held
+        [[nodiscard]] size_type versions() const noexcept { return this->sz + this->dead_count; }
+
+        // Opens a snapshot of the tree as of now
+        [[nodiscard]] snapshot_view snapshot() { return snapshot_view(*this, this->clock); }
+
+        // Ends every version at once; open snapshots keep the values they see
+        void clear() noexcept override {
+            const std::uint64_t stamp = ++this->clock;
+            for (_Node* node = base::_live(base::_leftmost(this->root)); node != nullptr;) {
+                // Retiring may free the node, so step past it first
+                _Node* next = base::_next(node);
+
+                node->augment.end = stamp;
+                node->augment.dead = true;
+                --this->sz;
+                ++this->dead_count;
+                this->_retire(node);
+
+                node = next;
+            }
+            this->_record_reset();
+        }
+
+        void insert(std::initializer_list<value_type> values) noexcept override {
+            for (const_reference value : values) {
+                this->insert(value);
+            }
+        }
+
+        std::pair<iterator, bool> insert(const_reference value) noexcept {
+            const std::uint64_t stamp = this->clock + 1;
+            auto [position, inserted] = base::insert(value);
+
+            _Node* node = base::_node_of(position);
+            if (inserted) {
+                node->augment.begin = stamp;
+            } else if (node->augment.dead) {
+                // Start a new life on the same node, keeping the old one while a snapshot can still read it
+                if (this->_pinned(node->augment.begin, node->augment.end)) {
+                    node->augment.history.emplace_back(node->augment.begin, node->augment.end);
+                }
+                node->augment.begin = stamp;
+                node->augment.dead = false;
+                ++this->sz;
+                --this->dead_count;
+                this->_record(change_kind::insert, value);
+                inserted = true;
+            } else {
+                return {position, false};
+            }
+
+            this->clock = stamp;
+            return {position, inserted};
+        }
+
+        size_type erase(const_reference value) {
+            _Node* node = this->_find_node(value);
+            if (node == nullptr) {
+                return 0;
+            }
+
+            this->_close(node);
+
+            return 1;
+        }
+
+        iterator erase(const_iterator position) {
+            _Node* node = base::_node_of(position);
+            _Node* next = base::_next(node);
+
+            this->_close(node);
+
+            return base::_iterator_at(next);
+        }
+
+        // Frees every closed version no open snapshot can see, including those the queue only reaches once older
+        // snapshots are released, and rebuilds the queue from the versions that remain
+        void collect() {
+            this->retired.clear();
+
+            std::vector<_Node*> unreachable;
+            for (_Node* node = base::_leftmost(this->root); node != nullptr; node = base::_successor(node)) {
+                version_stamp& stamp = node->augment;
+                std::erase_if(stamp.history, [this](const auto& interval) {
+                    return !this->_pinned(interval.first, interval.second);
+                });
+
+                stamp.retired = stamp.history.size();
+                for (const auto& interval : stamp.history) {
+                    this->retired.emplace_back(interval.second, node);
+                }
+
+                if (stamp.dead && this->_pinned(stamp.begin, stamp.end)) {
+                    this->retired.emplace_back(stamp.end, node);
+                    ++stamp.retired;
+                } else if (stamp.dead && stamp.history.empty()) {
+                    unreachable.push_back(node);
+                }
+            }
+            std::ranges::sort(this->retired, std::ranges::less(), &std::pair<std::uint64_t, _Node*>::first);
+
+            for (_Node* node : unreachable) {
+                this->_reclaim(node);
+            }
+        }
+
+        // Inserts the values of `sources` as new versions and clears the sources, instead of relinking their nodes
+        // like the base class does, so the versions open snapshots of this tree or of a multi-version source can
+        // see stay where they are. Takes O(m log n) for m values.
+        void absorb(std::span<typename base::binary_tree* const> sources) {
+            for (typename base::binary_tree* source : sources) {
+                if (source == this) {
+                    continue;
+                }
+
+                for (auto position = source->begin(); position != source->end(); ++position) {
+                    this->insert(*position);
+                }
+                source->clear();
+            }
+        }
+
+        // Open snapshots point at the tree, so its versions stay with it
+        void swap(mvcc_tree&) = delete;
+
+        friend void swap(mvcc_tree&, mvcc_tree&) = delete;
+
+    };
+
+    /* ------------------------------------------------Snapshot View------------------------------------------------ */
+    // The values of an `mvcc_tree` as of one timestamp, held open until the view is destroyed
+    template<class T, class Allocator>
+    class mvcc_tree<T, Allocator>::snapshot_view {
+    private:
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        mvcc_tree* tree;
+
+        std::uint64_t stamp;
+
+        /* ---------------------------------------------Friends----------------------------------------------------- */
+        friend class mvcc_tree;
+
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        snapshot_view(mvcc_tree& tree, std::uint64_t stamp) : tree(&tree), stamp(stamp) {
+            ++tree.snapshots[stamp];
+        }
+
+    public:
+        snapshot_view(const snapshot_view&) = delete;
+
+        snapshot_view(snapshot_view&& other) noexcept
+            : tree(std::exchange(other.tree, nullptr)), stamp(other.stamp) {}
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~snapshot_view() { this->release(); }
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        snapshot_view& operator=(const snapshot_view&) = delete;
+
+        snapshot_view& operator=(snapshot_view&& other) noexcept {
+            if (this != &other) {
+                this->release();
+                this->tree = std::exchange(other.tree, nullptr);
+                this->stamp = other.stamp;
+            }
+            return *this;
+        }
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] std::uint64_t timestamp() const noexcept { return this->stamp; }
+
+        [[nodiscard]] bool contains(const_reference value) const noexcept {
+            const _Node* node = this->tree->_lower_bound_version(value);
+            return node != nullptr && !(value < node->value) && node->augment.visible_at(this->stamp);
+        }
+
+        // Calls `visitor(value)` in ascending order for every value in [low, high) as of the snapshot. The visitor
+        // may write to the tree; the scan continues over the snapshot regardless.
+        template<class Visitor>
+        void scan(const_reference low, const_reference high, Visitor visitor) const {
+            for (_Node* node = this->tree->_lower_bound_version(low); node != nullptr && node->value < high;
+                 node = base::_successor(node)) {
+                if (node->augment.visible_at(this->stamp)) {
+                    visitor(node->value);
+                }
+            }
+        }
+
+        // Calls `visitor(value)` in ascending order for every value as of the snapshot
+        template<class Visitor>
+        void for_each(Visitor visitor) const {
+            for (_Node* node = base::_leftmost(this->tree->root); node != nullptr; node = base::_successor(node)) {
+                if (node->augment.visible_at(this->stamp)) {
+                    visitor(node->value);
+                }
+            }
+        }
+
+        // Closes the snapshot early, letting the versions only it could see be collected
+        void release() {
+            if (this->tree != nullptr) {
+                std::exchange(this->tree, nullptr)->_release(this->stamp);
+            }
+        }
+
+    };
+
+    namespace pmr {
+
+        template<class T>
+        using mvcc_tree = adt::mvcc_tree<T, std::pmr::polymorphic_allocator<T>>;
+
+    } // pmr
+
+} // adt
+
+
+#endif // MVCC_TREE_HPP
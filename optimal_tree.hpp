@@ -0,0 +1,248 @@
+#ifndef OPTIMAL_TREE_HPP
+#define OPTIMAL_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include <ranges>
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <numeric>
+#include <stdexcept>
+#include <limits>
+
+
+namespace adt {
+
+    /* ------------------------------------------------Optimal Tree------------------------------------------------- */
+    // An immutable binary search tree shaped by access weights, built by `build_optimal`. Nodes live in one array in
+    // preorder, with 32-bit child indices instead of pointers, so a lookup touches one contiguous block and frequent
+    // keys sit near the root (and near the start of the array).
+    template<class T, class Allocator = std::allocator<T>>
+    class optimal_tree {
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using value_type = T;
+
+        using key_type = T;
+
+        using allocator_type = Allocator;
+
+        using size_type = std::size_t;
+
+        using difference_type = std::ptrdiff_t;
+
+        using reference = value_type&;
+
+        using const_reference = const value_type&;
+
+    protected:
+        /* -------------------------------------------------Node---------------------------------------------------- */
+        struct _Node {
+            /* --------------------------------------------Fields--------------------------------------------------- */
+            value_type value;
+
+            // Child indices; the root is at index 0, so 0 can only mean "no child"
+            std::uint32_t left = 0;
+
+            std::uint32_t right = 0;
+
+            // Position of the value in the keys `build_optimal` was given
+            std::uint32_t index = 0;
+        };
+
+        using _NodeAllocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<_Node>;
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        std::vector<_Node, _NodeAllocator> nodes;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] const _Node* _find_node(const_reference value) const noexcept {
+            if (this->nodes.empty()) {
+                return nullptr;
+            }
+
+            std::uint32_t position = 0;
+            do {
+                const _Node& node = this->nodes[position];
+                if (value < node.value) {
+                    position = node.left;
+                } else if (node.value < value) {
+                    position = node.right;
+                } else {
+                    return &node;
+                }
+            } while (position != 0);
+
+            return nullptr;
+        }
+
+        /* ---------------------------------------------Friends----------------------------------------------------- */
+        template<std::ranges::random_access_range Keys, std::ranges::random_access_range Weights, class Alloc>
+        friend optimal_tree<std::ranges::range_value_t<Keys>, Alloc> build_optimal(const Keys&,
+                                                                                   const Weights&,
+                                                                                   const Alloc&);
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        optimal_tree() : optimal_tree(allocator_type()) {}
+
+        explicit optimal_tree(const allocator_type& allocator) : nodes(_NodeAllocator(allocator)) {}
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] size_type size() const noexcept { return this->nodes.size(); }
+
+        [[nodiscard]] bool empty() const noexcept { return this->nodes.empty(); }
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept {
+            return allocator_type(this->nodes.get_allocator());
+        }
+
+        [[nodiscard]] bool contains(const_reference value) const noexcept { return this->_find_node(value) != nullptr; }
+
+        // Position of `value` in the keys the tree was built from, e.g. to look up a payload stored alongside them
+        [[nodiscard]] std::optional<size_type> index_of(const_reference value) const noexcept {
+            const _Node* node = this->_find_node(value);
+            return node != nullptr ? std::optional<size_type>(node->index) : std::nullopt;
+        }
+
+        // Number of nodes a lookup of `value` compares against, hits and misses alike
+        [[nodiscard]] size_type depth(const_reference value) const noexcept {
+            size_type depth = 0;
+            if (this->nodes.empty()) {
+                return depth;
+            }
+
+            std::uint32_t position = 0;
+            do {
+                const _Node& node = this->nodes[position];
+                ++depth;
+                if (value < node.value) {
+                    position = node.left;
+                } else if (node.value < value) {
+                    position = node.right;
+                } else {
+                    break;
+                }
+            } while (position != 0);
+
+            return depth;
+        }
+
+    };
+
+    /* -----------------------------------------------Build Optimal------------------------------------------------- */
+    // Builds a nearly optimal search tree for `keys` accessed with frequencies `weights` using Mehlhorn's bisection
+    // rule: every subtree root is the key that best balances the weight on its two sides, found by binary search over
+    // prefix sums. That takes O(n log n), against O(n^2) for Knuth's exact dynamic program, and the expected lookup
+    // depth stays within 2 + H (the entropy of the weights) of the optimum. Duplicate keys keep their first position
+    // and add up their weights.
+    template<std::ranges::random_access_range Keys,
+             std::ranges::random_access_range Weights,
+             class Allocator = std::allocator<std::ranges::range_value_t<Keys>>>
+    [[nodiscard]] optimal_tree<std::ranges::range_value_t<Keys>, Allocator>
+    build_optimal(const Keys& keys, const Weights& weights, const Allocator& allocator = Allocator()) {
+        using value_type = std::ranges::range_value_t<Keys>;
+        using tree_type = optimal_tree<value_type, Allocator>;
+
+        const std::size_t count = std::ranges::size(keys);
+        if (std::ranges::size(weights) != count) {
+            throw std::invalid_argument("every key needs exactly one weight");
+        }
+        if (count > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("optimal trees index their nodes with 32 bits");
+        }
+
+        // Sort the key positions by key, merging duplicates into their first occurrence
+        std::vector<std::uint32_t> order(count);
+        std::iota(order.begin(), order.end(), std::uint32_t(0));
+        std::ranges::stable_sort(order, [&](std::uint32_t lhs, std::uint32_t rhs) { return keys[lhs] < keys[rhs]; });
+
+        std::vector<std::uint32_t> unique;
+        std::vector<double> prefix{0.0};
+        for (const std::uint32_t position : order) {
+            const double weight = static_cast<double>(weights[position]);
+            if (!unique.empty() && !(keys[unique.back()] < keys[position])) {
+                prefix.back() += weight;
+            } else {
+                unique.push_back(position);
+                prefix.push_back(prefix.back() + weight);
+            }
+        }
+
+        tree_type tree(allocator);
+        tree.nodes.reserve(unique.size());
+
+        // Emit nodes in preorder with an explicit stack, since skewed weights can make the tree deep
+        struct range {
+            std::size_t low;
+
+            std::size_t high;
+
+            // Index of the parent whose child link should point at the subtree root, and which link
+            std::size_t parent;
+
+            bool right;
+        };
+
+        std::vector<range> pending;
+        if (!unique.empty()) {
+            pending.push_back({0, unique.size(), std::numeric_limits<std::size_t>::max(), false});
+        }
+
+        while (!pending.empty()) {
+            const range current = pending.back();
+            pending.pop_back();
+
+            // The left side's weight minus the right side's only grows with the root, so bisect for the first root
+            // where it is no longer negative, and settle between it and its predecessor
+            const auto imbalance = [&](std::size_t root) {
+                return (prefix[root] - prefix[current.low]) - (prefix[current.high] - prefix[root + 1]);
+            };
+
+            std::size_t low = current.low;
+            std::size_t high = current.high - 1;
+            while (low < high) {
+                const std::size_t middle = low + (high - low) / 2;
+                if (imbalance(middle) < 0) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            if (low > current.low && -imbalance(low - 1) < imbalance(low)) {
+                --low;
+            }
+
+            const auto index = static_cast<std::uint32_t>(tree.nodes.size());
+            tree.nodes.push_back({keys[unique[low]], 0, 0, unique[low]});
+            if (current.parent != std::numeric_limits<std::size_t>::max()) {
+                (current.right ? tree.nodes[current.parent].right : tree.nodes[current.parent].left) = index;
+            }
+
+            // Push the right side first, so the left subtree is emitted right after its parent
+            if (low + 1 < current.high) {
+                pending.push_back({low + 1, current.high, index, true});
+            }
+            if (current.low < low) {
+                pending.push_back({current.low, low, index, false});
+            }
+        }
+
+        return tree;
+    }
+
+    namespace pmr {
+
+        template<class T>
+        using optimal_tree = adt::optimal_tree<T, std::pmr::polymorphic_allocator<T>>;
+
+    } // pmr
+
+} // adt
+
+
+#endif // OPTIMAL_TREE_HPP
@@ -0,0 +1,141 @@
+#ifndef RADIX_SORT_HPP
+#define RADIX_SORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <span>
+#include <thread>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <concepts>
+
+
+namespace adt {
+
+    /* ------------------------------------------------Radix Traits------------------------------------------------- */
+    // Maps a value to an unsigned integer whose order matches the value's order. Specialise it for record types whose
+    // order is decided by an integral key to let them use the radix sort.
+    template<class T>
+    struct radix_traits;
+
+    template<std::integral T>
+    struct radix_traits<T> {
+        using key_type = std::make_unsigned_t<T>;
+
+        [[nodiscard]] static constexpr key_type key(const T& value) noexcept {
+            // Flip the sign bit so that negative values order first
+            if constexpr (std::is_signed_v<T>) {
+                return static_cast<key_type>(value) ^ (key_type(1) << (sizeof(T) * 8 - 1));
+            } else {
+                return value;
+            }
+        }
+    };
+
+    template<class T>
+    concept radix_sortable = requires(const T& value) {
+        { radix_traits<T>::key(value) } -> std::unsigned_integral;
+    };
+
+    /* -------------------------------------------------Radix Sort-------------------------------------------------- */
+    // Stable LSD radix sort, one byte per pass. Each pass counts digits and scatters in parallel over contiguous
+    // chunks (one per worker), and passes on which every key has the same digit are skipped, so keys drawn from a
+    // narrow range cost fewer passes. `workers == 0` picks a count from the input size and the hardware.
+    template<radix_sortable T>
+    void radix_sort(std::span<T> values, std::size_t workers = 0) {
+        using key_type = std::remove_cvref_t<decltype(radix_traits<T>::key(std::declval<const T&>()))>;
+        using histogram = std::array<std::size_t, 256>;
+
+        const std::size_t count = values.size();
+        if (count < 2) {
+            return;
+        }
+
+        // Small inputs are not worth the buffer and the passes
+        if (count < 256) {
+            std::stable_sort(values.begin(), values.end(), [](const T& lhs, const T& rhs) {
+                return radix_traits<T>::key(lhs) < radix_traits<T>::key(rhs);
+            });
+            return;
+        }
+
+        if (workers == 0) {
+            constexpr std::size_t grain = std::size_t(1) << 16;
+            workers = std::clamp<std::size_t>(count / grain, 1, std::max(1u, std::thread::hardware_concurrency()));
+        }
+
+        const auto run = [workers](auto&& task) {
+            // Worker 0 runs on the calling thread
+            std::vector<std::thread> threads;
+            threads.reserve(workers - 1);
+            for (std::size_t worker = 1; worker < workers; ++worker) {
+                threads.emplace_back(task, worker);
+            }
+            task(std::size_t(0));
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        };
+
+        const auto chunk = [count, workers](std::size_t worker) {
+            return std::pair(count * worker / workers, count * (worker + 1) / workers);
+        };
+
+        std::vector<T> buffer(count);
+        T* source = values.data();
+        T* target = buffer.data();
+        std::vector<histogram> counts(workers);
+
+        for (std::size_t shift = 0; shift < sizeof(key_type) * 8; shift += 8) {
+            run([&](std::size_t worker) {
+                histogram& local = counts[worker];
+                local.fill(0);
+
+                const auto [first, last] = chunk(worker);
+                for (std::size_t i = first; i < last; ++i) {
+                    ++local[(radix_traits<T>::key(source[i]) >> shift) & 0xFF];
+                }
+            });
+
+            // Turn the per-worker counts into per-worker starting offsets, digit-major so the pass stays stable
+            std::size_t offset = 0;
+            bool trivial = false;
+            for (std::size_t digit = 0; digit < 256; ++digit) {
+                std::size_t total = 0;
+                for (std::size_t worker = 0; worker < workers; ++worker) {
+                    const std::size_t digits = counts[worker][digit];
+                    counts[worker][digit] = offset;
+                    offset += digits;
+                    total += digits;
+                }
+                trivial = trivial || total == count;
+            }
+
+            if (trivial) {
+                continue;
+            }
+
+            run([&](std::size_t worker) {
+                histogram& local = counts[worker];
+
+                const auto [first, last] = chunk(worker);
+                for (std::size_t i = first; i < last; ++i) {
+                    target[local[(radix_traits<T>::key(source[i]) >> shift) & 0xFF]++] = std::move(source[i]);
+                }
+            });
+
+            std::swap(source, target);
+        }
+
+        if (source != values.data()) {
+            std::move(source, source + count, values.data());
+        }
+    }
+
+} // adt
+
+
+#endif // RADIX_SORT_HPP
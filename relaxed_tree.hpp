@@ -0,0 +1,341 @@
+#ifndef RELAXED_TREE_HPP
+#define RELAXED_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <span>
+#include <chrono>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
+#include "avl_tree.hpp"
+
+
+namespace adt {
+
+    /* -------------------------------------------------Relaxed Slot------------------------------------------------ */
+    // Plain node data (not derived from the subtree): one past the node's position in its tree's queue of pending
+    // fix-ups, or 0 when it has none
+    struct relaxed_slot {
+        /* ----------------------------------------------Fields----------------------------------------------------- */
+        std::size_t queued = 0;
+
+        [[nodiscard]] constexpr bool operator==(const relaxed_slot&) const noexcept = default;
+
+    };
+
+    /* ------------------------------------------------Relaxed Tree------------------------------------------------- */
+    // An AVL tree with relaxed balance: `insert` and `erase` make only the local structural change and queue the
+    // spot where balance may now be violated, so their cost no longer includes a chain of rotations. The queued
+    // fix-ups are run by `rebalance_step(budget)`, a bounded amount of work at a time, either inline or from a
+    // `background_rebalancer`. Until the queue drains the tree is still ordered but may be taller than an AVL tree;
+    // once it drains it satisfies the AVL invariant again.
+    template<class T, class Allocator = std::allocator<T>>
+    class relaxed_tree : public avl_tree<T, Allocator, relaxed_slot> {
+    private:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using base = avl_tree<T, Allocator, relaxed_slot>;
+
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::value_type;
+
+        using typename base::allocator_type;
+
+        using typename base::size_type;
+
+        using typename base::difference_type;
+
+        using typename base::reference;
+
+        using typename base::const_reference;
+
+        using typename base::iterator;
+
+        using typename base::const_iterator;
+
+    protected:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::_Node;
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        // Nodes to walk up from, restoring heights and balance; every node is queued at most once
+        std::vector<_Node*> pending;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        void _enqueue(_Node* node) {
+            if (node != nullptr && node->augment.queued == 0) {
+                this->pending.push_back(node);
+                node->augment.queued = this->pending.size();
+            }
+        }
+
+        void _dequeue(_Node* node) noexcept {
+            if (node->augment.queued == 0) {
+                return;
+            }
+
+            // Swap the last entry into the vacated slot
+            _Node* last = this->pending.back();
+            this->pending[node->augment.queued - 1] = last;
+            last->augment.queued = node->augment.queued;
+            this->pending.pop_back();
+            node->augment.queued = 0;
+        }
+
+        [[nodiscard]] static bool _balanced(const _Node* node) noexcept {
+            const std::int32_t balance = base::_height(node->left) - base::_height(node->right);
+            return balance >= -1 && balance <= 1;
+        }
+
+        // Clones carry the source's queue positions, which mean nothing here: clear them, queueing the clones of the
+        // source's queued nodes instead
+        void _copy_pending(const relaxed_tree& other) {
+            this->pending.clear();
+
+            _Node* node = base::_leftmost(this->root);
+            _Node* source = base::_leftmost(other.root);
+            while (node != nullptr) {
+                node->augment.queued = 0;
+                if (source->augment.queued != 0) {
+                    this->_enqueue(node);
+                }
+                node = base::_successor(node);
+                source = base::_successor(source);
+            }
+        }
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        relaxed_tree() noexcept : base() {}
+
+        explicit relaxed_tree(const allocator_type& allocator) noexcept : base(allocator) {}
+
+        relaxed_tree(std::initializer_list<value_type> values, const allocator_type& allocator = allocator_type())
+            : base(allocator) {
+            this->insert(values);
+        }
+
+        // Bulk construction builds a perfectly balanced tree, so nothing is queued
+        template<std::input_iterator InputIterator>
+        relaxed_tree(InputIterator first, InputIterator last, const allocator_type& allocator = allocator_type())
+            : base(first, last, allocator) {}
+
+        relaxed_tree(const relaxed_tree& other) : base(other) { this->_copy_pending(other); }
+
+        // Moving construction always takes the nodes, and the queue with them
+        relaxed_tree(relaxed_tree&&) noexcept = default;
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~relaxed_tree() noexcept override = default;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        relaxed_tree& operator=(const relaxed_tree& other) {
+            if (this != &other) {
+                base::operator=(other);
+                this->_copy_pending(other);
+            }
+            return *this;
+        }
+
+        // Assignment may copy the nodes instead of taking them, so the source is fully rebalanced first and no queue
+        // has to follow
+        relaxed_tree& operator=(relaxed_tree&& other) {
+            if (this != &other) {
+                other.rebalance();
+                base::operator=(std::move(other));
+                this->pending.clear();
+            }
+            return *this;
+        }
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // Fix-ups still queued; zero means the tree satisfies the AVL invariant
+        [[nodiscard]] size_type pending_fixups() const noexcept { return this->pending.size(); }
+
+        void clear() noexcept override {
+            base::clear();
+            this->pending.clear();
+        }
+
+        void insert(std::initializer_list<value_type> values) noexcept override {
+            for (const_reference value : values) {
+                this->insert(value);
+            }
+        }
+
+        std::pair<iterator, bool> insert(const_reference value) {
+            _Node* parent = nullptr;
+            _Node* node = this->root;
+            while (node != nullptr) {
+                if (value < node->value) {
+                    parent = node;
+                    node = node->left;
+                } else if (node->value < value) {
+                    parent = node;
+                    node = node->right;
+                } else {
+                    return {base::_iterator_at(node), false};
+                }
+            }
+
+            // Linking the node refreshes the heights along its path, but nothing is rotated yet
+            node = this->_construct_node(value, parent, nullptr, nullptr);
+            if (parent == nullptr) {
+                this->root = node;
+            }
+
+            ++this->sz;
+            this->_enqueue(parent);
+            this->_record(change_kind::insert, value);
+
+            return {base::_iterator_at(node), true};
+        }
+
+        size_type erase(const_reference value) {
+            _Node* node = this->_find_node(value);
+            if (node == nullptr) {
+                return 0;
+            }
+
+            this->_record(change_kind::erase, value);
+            this->_dequeue(node);
+            this->_enqueue(this->_unlink_node(node));
+
+            return 1;
+        }
+
+        iterator erase(const_iterator position) {
+            _Node* node = base::_node_of(position);
+            _Node* next = base::_successor(node);
+
+            this->_record(change_kind::erase, node->value);
+            this->_dequeue(node);
+            this->_enqueue(this->_unlink_node(node));
+
+            return base::_iterator_at(next);
+        }
+
+        // Runs queued fix-ups for at most `budget` node visits, each O(1): walks up from a queued node toward the
+        // root, restoring heights and rotating where the balance is off. Returns whether the queue is now empty.
+        bool rebalance_step(size_type budget) {
+            while (budget != 0 && !this->pending.empty()) {
+                _Node* node = this->pending.back();
+                this->_dequeue(node);
+
+                while (node != nullptr) {
+                    if (budget == 0) {
+                        // Resume here next time
+                        this->_enqueue(node);
+                        break;
+                    }
+                    --budget;
+
+                    // Walks that meet merge, since this one continues to the root anyway
+                    this->_dequeue(node);
+
+                    _Node* top = this->_rebalance_at(node);
+                    if (top != node) {
+                        // Imbalance left over from deferred updates can exceed two, so one rotation may not settle
+                        // the nodes it moved down
+                        for (_Node* child : {top->left, top->right}) {
+                            if (child != nullptr && !_balanced(child)) {
+                                this->_enqueue(child);
+                            }
+                        }
+                    }
+                    node = top->parent;
+                }
+            }
+
+            return this->pending.empty();
+        }
+
+        // Runs every queued fix-up
+        void rebalance() {
+            while (!this->rebalance_step(this->sz + 1)) {}
+        }
+
+        void swap(relaxed_tree& other) noexcept {
+            base::swap(other);
+            this->pending.swap(other.pending);
+        }
+
+        friend void swap(relaxed_tree& lhs, relaxed_tree& rhs) noexcept { lhs.swap(rhs); }
+
+        // Absorbing relinks every node into a fresh balanced tree, so the queues of this tree and of any relaxed
+        // sources are drained first rather than carried over
+        void absorb(std::span<typename base::binary_tree* const> sources) {
+            this->rebalance();
+            for (typename base::binary_tree* source : sources) {
+                if (auto* relaxed = dynamic_cast<relaxed_tree*>(source); relaxed != nullptr) {
+                    relaxed->rebalance();
+                }
+            }
+
+            base::absorb(sources);
+        }
+
+    };
+
+    /* ---------------------------------------------Background Rebalancer------------------------------------------- */
+    // Runs `tree.rebalance_step(budget)` on a worker thread, holding `mutex` for each step and yielding between
+    // steps, until destroyed. Every other access to the tree must hold the same mutex. Bounded steps keep the time
+    // any writer waits for the lock short; when the tree is balanced the worker sleeps for `idle` between checks.
+    template<class Tree>
+    class background_rebalancer {
+    protected:
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        std::jthread worker;
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        background_rebalancer(Tree& tree,
+                              std::mutex& mutex,
+                              std::size_t budget = 64,
+                              std::chrono::microseconds idle = std::chrono::microseconds(200))
+            : worker([&tree, &mutex, budget, idle](std::stop_token stop) {
+                  while (!stop.stop_requested()) {
+                      bool balanced;
+                      {
+                          std::lock_guard lock(mutex);
+                          balanced = tree.rebalance_step(budget);
+                      }
+
+                      if (balanced) {
+                          std::this_thread::sleep_for(idle);
+                      } else {
+                          std::this_thread::yield();
+                      }
+                  }
+              }) {}
+
+        background_rebalancer(const background_rebalancer&) = delete;
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        // Stops and joins the worker
+        ~background_rebalancer() = default;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        background_rebalancer& operator=(const background_rebalancer&) = delete;
+
+    };
+
+    namespace pmr {
+
+        template<class T>
+        using relaxed_tree = adt::relaxed_tree<T, std::pmr::polymorphic_allocator<T>>;
+
+    } // pmr
+
+} // adt
+
+
+#endif // RELAXED_TREE_HPP
@@ -0,0 +1,277 @@
+#ifndef STRING_KEY_HPP
+#define STRING_KEY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <compare>
+#include <bit>
+
+
+namespace adt {
+
+    /* -------------------------------------------------String Key-------------------------------------------------- */
+    // A compact string key for the tree engines. The first eight bytes are kept inline as a big-endian integer, so
+    // most comparisons resolve with a single integer compare and never touch the key's bytes. The bytes themselves
+    // are not owned: a `string_tree` keeps them in a `string_arena` of its own, while other trees of keys need an
+    // arena the caller keeps alive.
+    class string_key {
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using size_type = std::uint32_t;
+
+        static constexpr std::size_t prefix_size = sizeof(std::uint64_t);
+
+    protected:
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        std::uint64_t prefix;
+
+        size_type length;
+
+        const char* bytes;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] static constexpr std::uint64_t _load_prefix(std::string_view text) noexcept {
+            // Pack the first bytes most-significant first (zero padded), so integer order is byte order
+            std::uint64_t prefix = 0;
+            const std::size_t count = std::min(text.size(), prefix_size);
+            for (std::size_t i = 0; i < count; ++i) {
+                prefix |= static_cast<std::uint64_t>(static_cast<unsigned char>(text[i])) << (8 * (prefix_size - 1 - i));
+            }
+
+            return prefix;
+        }
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        constexpr string_key() noexcept : prefix(0), length(0), bytes(nullptr) {}
+
+        // Refers to `text` without copying it; `text` must outlive the key (used for lookups)
+        constexpr explicit string_key(std::string_view text) noexcept
+            : prefix(_load_prefix(text)), length(static_cast<size_type>(text.size())), bytes(text.data()) {}
+
+        constexpr string_key(const string_key&) noexcept = default;
+
+        constexpr string_key(string_key&&) noexcept = default;
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        constexpr ~string_key() noexcept = default;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        constexpr string_key& operator=(const string_key&) noexcept = default;
+
+        constexpr string_key& operator=(string_key&&) noexcept = default;
+
+        [[nodiscard]] constexpr bool operator==(const string_key& other) const noexcept {
+            return this->prefix == other.prefix && this->length == other.length &&
+                   (this->length <= prefix_size ||
+                    std::char_traits<char>::compare(this->bytes + prefix_size,
+                                                    other.bytes + prefix_size,
+                                                    this->length - prefix_size) == 0);
+        }
+
+        [[nodiscard]] constexpr std::strong_ordering operator<=>(const string_key& other) const noexcept {
+            // The common case: the keys differ within their first eight bytes
+            if (this->prefix != other.prefix) {
+                return this->prefix <=> other.prefix;
+            }
+
+            // Equal prefixes, so only the bytes past the prefix can still differ
+            const size_type shortest = std::min(this->length, other.length);
+            if (shortest > prefix_size) {
+                const int order = std::char_traits<char>::compare(this->bytes + prefix_size,
+                                                                  other.bytes + prefix_size,
+                                                                  shortest - prefix_size);
+                if (order != 0) {
+                    return order <=> 0;
+                }
+            }
+
+            return this->length <=> other.length;
+        }
+
+        [[nodiscard]] constexpr operator std::string_view() const noexcept { return {this->bytes, this->length}; }
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] constexpr std::size_t size() const noexcept { return this->length; }
+
+        [[nodiscard]] constexpr bool empty() const noexcept { return this->length == 0; }
+
+        [[nodiscard]] constexpr const char* data() const noexcept { return this->bytes; }
+
+        [[nodiscard]] constexpr std::string_view view() const noexcept { return {this->bytes, this->length}; }
+
+    };
+
+    /* ------------------------------------------------String Arena------------------------------------------------- */
+    // Bump allocator for key bytes. Blocks are never moved or freed individually, so keys stay valid until the
+    // arena is cleared or destroyed; erased keys are only reclaimed then.
+    template<class Allocator = std::allocator<char>>
+    class basic_string_arena {
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using allocator_type = Allocator;
+
+        using size_type = std::size_t;
+
+    protected:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using allocator_traits = typename std::allocator_traits<allocator_type>;
+
+        struct _Block {
+            char* data;
+
+            size_type capacity;
+        };
+
+        using _BlockAllocator = typename allocator_traits::template rebind_alloc<_Block>;
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        allocator_type allocator;
+
+        std::vector<_Block, _BlockAllocator> blocks;
+
+        size_type block_size;
+
+        size_type used;
+
+        size_type total;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        char* _allocate(size_type count) {
+            // Keys larger than a block get a block of their own
+            if (this->blocks.empty() || this->blocks.back().capacity - this->used < count) {
+                const size_type capacity = std::max(count, this->block_size);
+                this->blocks.push_back({allocator_traits::allocate(this->allocator, capacity), capacity});
+                this->used = 0;
+            }
+
+            char* data = this->blocks.back().data + this->used;
+            this->used += count;
+            this->total += count;
+
+            return data;
+        }
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        explicit basic_string_arena(size_type block_size = 64 * 1024, const allocator_type& allocator = allocator_type())
+            : allocator(allocator), blocks(_BlockAllocator(allocator)), block_size(block_size), used(0), total(0) {}
+
+        basic_string_arena(const basic_string_arena&) = delete;
+
+        basic_string_arena(basic_string_arena&& other) noexcept
+            : allocator(std::move(other.allocator)),
+              blocks(std::move(other.blocks)),
+              block_size(other.block_size),
+              used(other.used),
+              total(other.total) {
+            other.blocks.clear();
+            other.used = 0;
+            other.total = 0;
+        }
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~basic_string_arena() noexcept { this->clear(); }
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        basic_string_arena& operator=(const basic_string_arena&) = delete;
+
+        basic_string_arena& operator=(basic_string_arena&& other) noexcept {
+            if (this == &other) {
+                return *this;
+            }
+
+            this->clear();
+            this->allocator = std::move(other.allocator);
+            this->blocks = std::move(other.blocks);
+            this->block_size = other.block_size;
+            this->used = other.used;
+            this->total = other.total;
+
+            other.blocks.clear();
+            other.used = 0;
+            other.total = 0;
+
+            return *this;
+        }
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // Copies `text` into the arena and returns a key referring to the copy
+        [[nodiscard]] string_key intern(std::string_view text) {
+            char* data = this->_allocate(text.size());
+            if (!text.empty()) {
+                std::memcpy(data, text.data(), text.size());
+            }
+
+            return string_key(std::string_view(data, text.size()));
+        }
+
+        // Takes over the blocks of `other`, which must use an equal allocator: keys interned there stay valid and
+        // now belong to this arena
+        void splice(basic_string_arena& other) {
+            if (this->blocks.empty()) {
+                this->blocks.swap(other.blocks);
+                this->used = other.used;
+            } else {
+                // Keep filling our own current block
+                this->blocks.insert(this->blocks.end() - 1, other.blocks.begin(), other.blocks.end());
+                other.blocks.clear();
+            }
+            this->total += other.total;
+
+            other.used = 0;
+            other.total = 0;
+        }
+
+        // Exchanges the blocks, and the keys interned in them, with `other`; the allocators are exchanged only when
+        // they propagate on swap, and must otherwise be equal
+        void swap(basic_string_arena& other) noexcept {
+            using std::swap;
+            if constexpr (allocator_traits::propagate_on_container_swap::value) {
+                swap(this->allocator, other.allocator);
+            }
+            this->blocks.swap(other.blocks);
+            swap(this->block_size, other.block_size);
+            swap(this->used, other.used);
+            swap(this->total, other.total);
+        }
+
+        friend void swap(basic_string_arena& lhs, basic_string_arena& rhs) noexcept { lhs.swap(rhs); }
+
+        // Invalidates every key interned so far
+        void clear() noexcept {
+            for (const _Block& block : this->blocks) {
+                allocator_traits::deallocate(this->allocator, block.data, block.capacity);
+            }
+
+            this->blocks.clear();
+            this->used = 0;
+            this->total = 0;
+        }
+
+        [[nodiscard]] size_type bytes_used() const noexcept { return this->total; }
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept { return this->allocator; }
+
+    };
+
+    using string_arena = basic_string_arena<>;
+
+} // adt
+
+
+template<>
+struct std::hash<adt::string_key> {
+    [[nodiscard]] std::size_t operator()(const adt::string_key& key) const noexcept {
+        return std::hash<std::string_view>{}(key.view());
+    }
+};
+
+
+#endif // STRING_KEY_HPP
@@ -0,0 +1,205 @@
+#ifndef STRING_TREE_HPP
+#define STRING_TREE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <initializer_list>
+#include <string_view>
+#include <span>
+#include <utility>
+
+#include "avl_tree.hpp"
+#include "string_key.hpp"
+
+
+namespace adt {
+
+    /* ------------------------------------------------String Tree-------------------------------------------------- */
+    // An AVL tree of `string_key`s that owns the bytes of its keys: inserting copies a new key into the tree's own
+    // `string_arena`, allocated from the tree's allocator, so callers never have to keep the text alive. Lookups
+    // take plain string views and copy nothing. Erased keys' bytes are reclaimed by `clear()` or destruction.
+    template<class Allocator = std::allocator<string_key>, class Augment = no_augment>
+    class string_tree : public avl_tree<string_key, Allocator, Augment> {
+    private:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using base = avl_tree<string_key, Allocator, Augment>;
+
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::value_type;
+
+        using typename base::allocator_type;
+
+        using typename base::size_type;
+
+        using typename base::difference_type;
+
+        using typename base::reference;
+
+        using typename base::const_reference;
+
+        using typename base::iterator;
+
+        using typename base::const_iterator;
+
+        using arena_type = basic_string_arena<typename std::allocator_traits<Allocator>::template rebind_alloc<char>>;
+
+    protected:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::_Node;
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        arena_type arena;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // Points every key at a copy in this tree's arena, after nodes were cloned from another tree
+        void _intern_all() {
+            for (_Node* node = base::_leftmost(this->root); node != nullptr; node = base::_successor(node)) {
+                node->value = this->arena.intern(node->value.view());
+            }
+        }
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        string_tree() : string_tree(allocator_type()) {}
+
+        explicit string_tree(const allocator_type& allocator)
+            : base(allocator), arena(64 * 1024, typename arena_type::allocator_type(allocator)) {}
+
+        string_tree(std::initializer_list<std::string_view> values, const allocator_type& allocator = allocator_type())
+            : string_tree(allocator) {
+            for (const std::string_view value : values) {
+                this->insert(value);
+            }
+        }
+
+        string_tree(const string_tree& other)
+            : base(other), arena(64 * 1024, typename arena_type::allocator_type(this->get_allocator())) {
+            this->_intern_all();
+        }
+
+        // Move construction always takes the nodes, and the arena their keys point into goes with them
+        string_tree(string_tree&&) noexcept = default;
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~string_tree() noexcept override = default;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        string_tree& operator=(const string_tree& other) {
+            if (this != &other) {
+                base::operator=(other);
+                this->arena.clear();
+                this->_intern_all();
+            }
+            return *this;
+        }
+
+        string_tree& operator=(string_tree&& other) {
+            if (this == &other) {
+                return *this;
+            }
+
+            // The base takes the nodes exactly when the allocators are equal or propagate, so decide on the same
+            const bool equal = this->get_allocator() == other.get_allocator();
+            base::operator=(std::move(other));
+            if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+                // The allocator came along with the nodes, so the arena does too
+                this->arena = std::move(other.arena);
+                return *this;
+            }
+
+            this->arena.clear();
+            if (equal) {
+                // The nodes were taken, so the bytes their keys point at come along too
+                this->arena.splice(other.arena);
+            } else {
+                // The nodes were copied into our allocator, so their keys are copied into our arena as well
+                this->_intern_all();
+                other.clear();
+            }
+
+            return *this;
+        }
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        using base::contains;
+
+        using base::find;
+
+        using base::erase;
+
+        [[nodiscard]] const arena_type& keys() const noexcept { return this->arena; }
+
+        // Swaps the arenas along with the nodes, so every key stays with the bytes it points at
+        void swap(string_tree& other) noexcept {
+            base::swap(other);
+            this->arena.swap(other.arena);
+        }
+
+        friend void swap(string_tree& lhs, string_tree& rhs) noexcept { lhs.swap(rhs); }
+
+        // Relinks the nodes of `sources` into this tree like the base class does, then copies every key into a
+        // fresh arena of this tree's, since the absorbed ones point into the sources' arenas or the caller's memory.
+        // String tree sources are left with empty arenas as well as no nodes.
+        void absorb(std::span<typename base::binary_tree* const> sources) {
+            base::absorb(sources);
+
+            arena_type interned(64 * 1024, this->arena.get_allocator());
+            for (_Node* node = base::_leftmost(this->root); node != nullptr; node = base::_successor(node)) {
+                node->value = interned.intern(node->value.view());
+            }
+            this->arena.swap(interned);
+
+            for (typename base::binary_tree* source : sources) {
+                if (auto* tree = dynamic_cast<string_tree*>(source); tree != nullptr && tree != this) {
+                    tree->arena.clear();
+                }
+            }
+        }
+
+        void clear() noexcept override {
+            base::clear();
+            this->arena.clear();
+        }
+
+        void insert(std::initializer_list<value_type> values) noexcept override {
+            for (const_reference value : values) {
+                this->insert(value);
+            }
+        }
+
+        // Copies the key's bytes into the tree only if it is not already present
+        std::pair<iterator, bool> insert(const_reference value) {
+            if (const iterator position = base::find(value); position != this->end()) {
+                return {position, false};
+            }
+
+            return base::insert(this->arena.intern(value.view()));
+        }
+
+        std::pair<iterator, bool> insert(std::string_view value) { return this->insert(string_key(value)); }
+
+        [[nodiscard]] bool contains(std::string_view value) const noexcept {
+            return base::contains(string_key(value));
+        }
+
+        [[nodiscard]] const_iterator find(std::string_view value) const noexcept {
+            return base::find(string_key(value));
+        }
+
+        size_type erase(std::string_view value) { return base::erase(string_key(value)); }
+
+    };
+
+    namespace pmr {
+
+        template<class Augment = no_augment>
+        using string_tree = adt::string_tree<std::pmr::polymorphic_allocator<string_key>, Augment>;
+
+    } // pmr
+
+} // adt
+
+
+#endif // STRING_TREE_HPP
@@ -0,0 +1,118 @@
+#ifndef SWAPPABLE_INDEX_HPP
+#define SWAPPABLE_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+
+#include "binary_tree.hpp"
+
+
+namespace adt {
+
+    /* -----------------------------------------------Swappable Index----------------------------------------------- */
+    // A tree that readers only ever see as an immutable version. `snapshot()` hands out a reference-counted handle
+    // to the current version. Builders make the next version aside, either a bulk build from scratch (`rebuild`)
+    // or a copy of the current one with a patch applied (`update`), and `publish` it with one atomic pointer swap.
+    // Readers never wait on a build, and a version is freed when its last handle goes away. Builders are serialized
+    // among themselves, so a patch never loses another builder's changes.
+    //
+    // Lookups on a published tree must not write to it. Every version is sealed before it is published: the lookup
+    // cache (`cache_lookups`), which writes on every lookup, is turned off, and a stale directory (`index_top_levels`)
+    // is rebuilt up front instead of by the first lookup. The filter and the point index are only read by lookups.
+    template<class Tree>
+        requires requires { typename Tree::binary_tree; }
+    class swappable_index {
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using tree_type = Tree;
+
+        using value_type = typename Tree::value_type;
+
+        using handle = std::shared_ptr<const Tree>;
+
+    protected:
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        std::atomic<handle> current;
+
+        std::atomic<std::uint64_t> published = 0;
+
+        // Held by builders only, never by readers
+        std::mutex building;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // Leaves nothing in `tree` that a lookup would write to
+        [[nodiscard]] static handle _seal(std::shared_ptr<Tree> tree) {
+            if constexpr (requires { tree->cache_lookups(0); }) {
+                tree->cache_lookups(0);
+            }
+            if constexpr (requires { tree->refresh_directory(); }) {
+                tree->refresh_directory();
+            }
+
+            return tree;
+        }
+
+        handle _install(std::shared_ptr<Tree> tree) {
+            handle next = this->current.exchange(_seal(std::move(tree)), std::memory_order_acq_rel);
+            this->published.fetch_add(1, std::memory_order_release);
+            return next;
+        }
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        swappable_index() : current(std::make_shared<const Tree>()) {}
+
+        explicit swappable_index(Tree initial) : current(_seal(std::make_shared<Tree>(std::move(initial)))) {}
+
+        swappable_index(const swappable_index&) = delete;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        swappable_index& operator=(const swappable_index&) = delete;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // The current version; it stays valid and unchanged for as long as the handle is held
+        [[nodiscard]] handle snapshot() const noexcept { return this->current.load(std::memory_order_acquire); }
+
+        // Number of versions published since construction
+        [[nodiscard]] std::uint64_t version() const noexcept { return this->published.load(std::memory_order_acquire); }
+
+        // Makes `next` the current version, returning the one it replaces
+        handle publish(Tree next) {
+            std::lock_guard lock(this->building);
+            return this->_install(std::make_shared<Tree>(std::move(next)));
+        }
+
+        // Builds a new version from unsorted values with the engine's bulk constructor and publishes it
+        template<std::input_iterator InputIterator>
+            requires std::is_constructible_v<Tree, InputIterator, InputIterator>
+        handle rebuild(InputIterator first, InputIterator last) {
+            auto next = std::make_shared<Tree>(first, last);
+
+            std::lock_guard lock(this->building);
+            return this->_install(std::move(next));
+        }
+
+        // Copies the current version, calls `patch(copy)` and publishes the result, returning the replaced version
+        template<class Patch>
+            requires std::is_invocable_v<Patch&, Tree&>
+        handle update(Patch patch) {
+            std::lock_guard lock(this->building);
+
+            auto next = std::make_shared<Tree>(*this->snapshot());
+            patch(*next);
+
+            return this->_install(std::move(next));
+        }
+
+    };
+
+} // adt
+
+
+#endif // SWAPPABLE_INDEX_HPP
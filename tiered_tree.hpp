@@ -0,0 +1,562 @@
+#ifndef TIERED_TREE_HPP
+#define TIERED_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <memory>
+#include <memory_resource>
+#include <initializer_list>
+#include <vector>
+#include <span>
+#include <string>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "avl_tree.hpp"
+
+
+namespace adt {
+
+    /* -------------------------------------------------Spill File-------------------------------------------------- */
+    // A scratch file of records, mapped into memory. The file is unlinked as soon as it is created, so it disappears
+    // with the process; its pages are backed by the file rather than by anonymous memory, so the kernel can drop
+    // them under pressure without touching swap. Released records leave holes that later appends fill, so the file
+    // only grows with the bytes held at once.
+    class spill_file {
+    protected:
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        int descriptor = -1;
+
+        std::byte* data = nullptr;
+
+        std::size_t capacity = 0;
+
+        std::size_t used = 0;
+
+        // Bytes still referenced; once nothing is, appends start over from the beginning
+        std::size_t live = 0;
+
+        // Released extents below `used`, as (offset, bytes), sorted by offset and never adjacent to each other
+        std::vector<std::pair<std::size_t, std::size_t>> holes;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // Records are kept aligned for any fundamental type
+        [[nodiscard]] static constexpr std::size_t _extent(std::size_t bytes) noexcept {
+            return (bytes + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        }
+
+        void _release_hole(std::size_t offset, std::size_t extent) {
+            auto next = std::ranges::lower_bound(this->holes, offset, std::ranges::less(), [](const auto& hole) {
+                return hole.first;
+            });
+
+            // Merge with the holes on either side
+            if (next != this->holes.end() && offset + extent == next->first) {
+                extent += next->second;
+                next = this->holes.erase(next);
+            }
+            if (next != this->holes.begin() && std::prev(next)->first + std::prev(next)->second == offset) {
+                std::prev(next)->second += extent;
+                next = std::prev(next);
+            } else {
+                next = this->holes.insert(next, {offset, extent});
+            }
+
+            // A hole at the end just shortens the file
+            if (next->first + next->second == this->used) {
+                this->used = next->first;
+                this->holes.erase(next);
+            }
+        }
+
+        void _reserve(std::size_t bytes) {
+            if (bytes <= this->capacity) {
+                return;
+            }
+
+            const std::size_t grown = std::max({bytes, 2 * this->capacity, std::size_t(1) << 20});
+            if (::ftruncate(this->descriptor, static_cast<off_t>(grown)) != 0) {
+                throw std::system_error(errno, std::generic_category(), "cannot grow the spill file");
+            }
+
+            void* mapped = this->data != nullptr
+                ? ::mremap(this->data, this->capacity, grown, MREMAP_MAYMOVE)
+                : ::mmap(nullptr, grown, PROT_READ | PROT_WRITE, MAP_SHARED, this->descriptor, 0);
+            if (mapped == MAP_FAILED) {
+                throw std::system_error(errno, std::generic_category(), "cannot map the spill file");
+            }
+
+            this->data = static_cast<std::byte*>(mapped);
+            this->capacity = grown;
+        }
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        // `directory` is where the scratch file is created, e.g. a local disk rather than a network mount
+        explicit spill_file(const std::string& directory = "/tmp") {
+            std::string path = directory + "/adt-spill-XXXXXX";
+            this->descriptor = ::mkstemp(path.data());
+            if (this->descriptor < 0) {
+                throw std::system_error(errno, std::generic_category(), "cannot create a spill file");
+            }
+            ::unlink(path.c_str());
+        }
+
+        spill_file(const spill_file&) = delete;
+
+        spill_file(spill_file&& other) noexcept
+            : descriptor(std::exchange(other.descriptor, -1)),
+              data(std::exchange(other.data, nullptr)),
+              capacity(std::exchange(other.capacity, 0)),
+              used(std::exchange(other.used, 0)),
+              live(std::exchange(other.live, 0)),
+              holes(std::move(other.holes)) {}
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~spill_file() noexcept {
+            if (this->data != nullptr) {
+                ::munmap(this->data, this->capacity);
+            }
+            if (this->descriptor >= 0) {
+                ::close(this->descriptor);
+            }
+        }
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        spill_file& operator=(const spill_file&) = delete;
+
+        spill_file& operator=(spill_file&& other) noexcept {
+            using std::swap;
+            swap(this->descriptor, other.descriptor);
+            swap(this->data, other.data);
+            swap(this->capacity, other.capacity);
+            swap(this->used, other.used);
+            swap(this->live, other.live);
+            swap(this->holes, other.holes);
+            return *this;
+        }
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // Copies `bytes` bytes into the first hole large enough, or else to the end of the file, and returns their
+        // offset
+        std::size_t append(const void* source, std::size_t bytes) {
+            const std::size_t extent = _extent(bytes);
+
+            std::size_t offset = this->used;
+            const auto hole = std::ranges::find_if(this->holes, [extent](const auto& hole) {
+                return hole.second >= extent;
+            });
+            if (hole != this->holes.end()) {
+                offset = hole->first;
+                hole->first += extent;
+                hole->second -= extent;
+                if (hole->second == 0) {
+                    this->holes.erase(hole);
+                }
+            } else {
+                this->_reserve(offset + extent);
+                this->used = offset + extent;
+            }
+
+            std::memcpy(this->data + offset, source, bytes);
+            this->live += extent;
+            return offset;
+        }
+
+        [[nodiscard]] const std::byte* at(std::size_t offset) const noexcept { return this->data + offset; }
+
+        // Frees the record of `bytes` bytes at `offset` for reuse
+        void release(std::size_t offset, std::size_t bytes) noexcept {
+            const std::size_t extent = _extent(bytes);
+            this->live -= extent;
+            if (this->live == 0) {
+                this->clear();
+                return;
+            }
+
+            try {
+                this->_release_hole(offset, extent);
+            } catch (...) {
+                // The hole could not be recorded; its bytes stay unused until the file is cleared
+            }
+        }
+
+        void clear() noexcept {
+            this->used = 0;
+            this->live = 0;
+            this->holes.clear();
+        }
+
+        // Bytes the records span, holes between them included
+        [[nodiscard]] std::size_t size() const noexcept { return this->used; }
+
+    };
+
+    /* ------------------------------------------------Access Epoch------------------------------------------------- */
+    // Plain node data (not derived from the subtree): the budget check during which the node was last used. Reads
+    // stamp it too, so it is mutable.
+    struct access_epoch {
+        /* ----------------------------------------------Fields----------------------------------------------------- */
+        mutable std::uint32_t epoch = 0;
+
+        [[nodiscard]] constexpr bool operator==(const access_epoch&) const noexcept = default;
+
+    };
+
+    /* ------------------------------------------------Tiered Tree-------------------------------------------------- */
+    // An AVL tree with a memory budget. Each `enforce_budget()` call closes an access window: while the resident
+    // nodes exceed the budget, runs of consecutive values that were not used for `window` windows are written to a
+    // `spill_file` and their nodes freed, leaving a small stub (the run's bounds and file offset) in a directory
+    // beside the tree. `contains` reads spilled runs in place; `find`, `insert` and `erase` fault a run back in
+    // before touching its range, so spilled ranges never hold resident values. Reads, const ones included, mark the
+    // resident values they hit as used. Iteration, comparison and the other
+    // whole-tree operations only see resident values: call `restore()` first to bring everything back.
+    template<class T, class Allocator = std::allocator<T>>
+        requires std::is_trivially_copyable_v<T>
+    class tiered_tree : public avl_tree<T, Allocator, access_epoch> {
+    private:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using base = avl_tree<T, Allocator, access_epoch>;
+
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::value_type;
+
+        using typename base::allocator_type;
+
+        using typename base::size_type;
+
+        using typename base::difference_type;
+
+        using typename base::reference;
+
+        using typename base::const_reference;
+
+        using typename base::iterator;
+
+        using typename base::const_iterator;
+
+    protected:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using typename base::_Node;
+
+        // Stub of a spilled run: no resident value lies within [low, high]
+        struct _Run {
+            value_type low;
+
+            value_type high;
+
+            std::size_t offset;
+
+            std::size_t count;
+        };
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        spill_file file;
+
+        // Sorted by `low`; runs never overlap
+        std::vector<_Run> runs;
+
+        size_type spilled_count = 0;
+
+        size_type budget;
+
+        std::uint32_t window;
+
+        std::uint32_t epoch = 1;
+
+        // Shorter cold stretches are left resident, since their stubs would cost more than they save
+        static constexpr size_type min_run = 64;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // Index of the run whose range holds `value`, or `runs.size()`
+        [[nodiscard]] std::size_t _run_of(const_reference value) const noexcept {
+            const auto run = std::ranges::upper_bound(this->runs, value, std::ranges::less(), &_Run::low);
+            if (run == this->runs.begin() || (run - 1)->high < value) {
+                return this->runs.size();
+            }
+
+            return static_cast<std::size_t>(run - 1 - this->runs.begin());
+        }
+
+        [[nodiscard]] const value_type* _values(const _Run& run) const noexcept {
+            return reinterpret_cast<const value_type*>(this->file.at(run.offset));
+        }
+
+        void _stamp(const _Node* node) const noexcept { node->augment.epoch = this->epoch; }
+
+        // Does not throw: inserting into the base tree does not, and removing a stub moves trivially copyable ones
+        void _fault_in(std::size_t index) noexcept {
+            const _Run run = this->runs[index];
+            this->runs.erase(this->runs.begin() + static_cast<std::ptrdiff_t>(index));
+            this->spilled_count -= run.count;
+
+            const value_type* values = this->_values(run);
+            for (std::size_t i = 0; i < run.count; ++i) {
+                this->_stamp(base::_node_of(base::insert(values[i]).first));
+            }
+
+            this->file.release(run.offset, run.count * sizeof(value_type));
+        }
+
+        void _fault_in(const_reference value) noexcept {
+            if (const std::size_t index = this->_run_of(value); index != this->runs.size()) {
+                this->_fault_in(index);
+            }
+        }
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        // `budget` is in bytes of resident nodes
+        explicit tiered_tree(size_type budget,
+                             std::uint32_t window = 1,
+                             spill_file file = spill_file(),
+                             const allocator_type& allocator = allocator_type())
+            : base(allocator), file(std::move(file)), budget(budget), window(window) {}
+
+        tiered_tree(const tiered_tree&) = delete;
+
+        tiered_tree(tiered_tree&& other) noexcept
+            : base(std::move(other)),
+              file(std::move(other.file)),
+              runs(std::exchange(other.runs, {})),
+              spilled_count(std::exchange(other.spilled_count, 0)),
+              budget(other.budget),
+              window(other.window),
+              epoch(other.epoch) {}
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~tiered_tree() noexcept override = default;
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        tiered_tree& operator=(const tiered_tree&) = delete;
+
+        // The spilled runs always move over, since the file does not depend on the allocator; when the base copies
+        // the resident nodes instead of taking them, the source is left with those alone
+        tiered_tree& operator=(tiered_tree&& other) {
+            if (this == &other) {
+                return *this;
+            }
+
+            base::operator=(std::move(other));
+            this->file = std::move(other.file);
+            other.file.clear();
+            this->runs = std::exchange(other.runs, {});
+            this->spilled_count = std::exchange(other.spilled_count, 0);
+            this->budget = other.budget;
+            this->window = other.window;
+            this->epoch = other.epoch;
+
+            return *this;
+        }
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        // Resident and spilled values together
+        [[nodiscard]] size_type size() const noexcept { return this->sz + this->spilled_count; }
+
+        [[nodiscard]] bool empty() const noexcept { return this->size() == 0; }
+
+        [[nodiscard]] size_type resident() const noexcept { return this->sz; }
+
+        [[nodiscard]] size_type spilled() const noexcept { return this->spilled_count; }
+
+        [[nodiscard]] size_type resident_bytes() const noexcept { return this->sz * sizeof(_Node); }
+
+        void clear() noexcept override {
+            base::clear();
+            this->runs.clear();
+            this->spilled_count = 0;
+            this->file.clear();
+        }
+
+        void insert(std::initializer_list<value_type> values) noexcept override {
+            for (const_reference value : values) {
+                this->insert(value);
+            }
+        }
+
+        std::pair<iterator, bool> insert(const_reference value) noexcept {
+            this->_fault_in(value);
+
+            const auto result = base::insert(value);
+            this->_stamp(base::_node_of(result.first));
+            return result;
+        }
+
+        // Erasing by position needs no fault-in, since positions only ever refer to resident values
+        using base::erase;
+
+        size_type erase(const_reference value) {
+            this->_fault_in(value);
+            return base::erase(value);
+        }
+
+        [[nodiscard]] bool contains(const_reference value) const noexcept override {
+            if (const _Node* node = this->_find_node(value); node != nullptr) {
+                this->_stamp(node);
+                return true;
+            }
+
+            const std::size_t index = this->_run_of(value);
+            if (index == this->runs.size()) {
+                return false;
+            }
+
+            const _Run& run = this->runs[index];
+            return std::binary_search(this->_values(run), this->_values(run) + run.count, value);
+        }
+
+        [[nodiscard]] iterator find(const_reference value) {
+            this->_fault_in(value);
+
+            const iterator position = base::find(value);
+            if (position != this->end()) {
+                this->_stamp(base::_node_of(position));
+            }
+            return position;
+        }
+
+        // A const tree cannot fault a run in, so this only finds resident values; spilled ones need the overload
+        // above, or `contains`
+        [[nodiscard]] const_iterator find(const_reference value) const noexcept {
+            const_iterator position = base::find(value);
+            if (position != this->cend()) {
+                this->_stamp(base::_node_of(position));
+            }
+            return position;
+        }
+
+        // Swaps the spilled runs and their file along with the resident nodes
+        void swap(tiered_tree& other) noexcept {
+            using std::swap;
+            base::swap(other);
+            swap(this->file, other.file);
+            this->runs.swap(other.runs);
+            swap(this->spilled_count, other.spilled_count);
+            swap(this->budget, other.budget);
+            swap(this->window, other.window);
+            swap(this->epoch, other.epoch);
+        }
+
+        friend void swap(tiered_tree& lhs, tiered_tree& rhs) noexcept { lhs.swap(rhs); }
+
+        // Absorbing merges resident nodes only, so this tree and any tiered sources fault everything back in first
+        void absorb(std::span<typename base::binary_tree* const> sources) {
+            this->restore();
+            for (typename base::binary_tree* source : sources) {
+                if (auto* tiered = dynamic_cast<tiered_tree*>(source); tiered != nullptr) {
+                    tiered->restore();
+                }
+            }
+
+            base::absorb(sources);
+        }
+
+        // Closes the current access window and spills cold runs until the resident nodes fit in the budget. Returns
+        // the number of values spilled.
+        size_type enforce_budget() {
+            ++this->epoch;
+            if (this->resident_bytes() <= this->budget) {
+                return 0;
+            }
+
+            const size_type excess = (this->resident_bytes() - this->budget + sizeof(_Node) - 1) / sizeof(_Node);
+            size_type spilled = 0;
+
+            std::vector<_Node*> keep;
+            std::vector<_Node*> cold;
+            std::vector<_Node*> freed;
+            std::vector<value_type> buffer;
+            std::vector<_Run> added;
+            keep.reserve(this->sz);
+
+            const auto flush = [&]() {
+                if (cold.size() >= min_run && spilled < excess) {
+                    // Spill only what the budget still needs; the rest of the run stays resident
+                    const auto count = static_cast<std::ptrdiff_t>(std::min<size_type>(cold.size(), excess - spilled));
+
+                    buffer.clear();
+                    for (auto node = cold.begin(); node != cold.begin() + count; ++node) {
+                        buffer.push_back((*node)->value);
+                    }
+
+                    const std::size_t offset = this->file.append(buffer.data(), buffer.size() * sizeof(value_type));
+                    added.push_back({buffer.front(), buffer.back(), offset, buffer.size()});
+                    freed.insert(freed.end(), cold.begin(), cold.begin() + count);
+                    keep.insert(keep.end(), cold.begin() + count, cold.end());
+                    spilled += buffer.size();
+                } else {
+                    keep.insert(keep.end(), cold.begin(), cold.end());
+                }
+                cold.clear();
+            };
+
+            // Walk the resident values in order; a cold run also ends where an existing stub lies between two values,
+            // so that runs never overlap
+            std::size_t next_run = 0;
+            for (_Node* node = base::_leftmost(this->root); node != nullptr; node = base::_successor(node)) {
+                bool crossed = false;
+                while (next_run < this->runs.size() && this->runs[next_run].low < node->value) {
+                    crossed = true;
+                    ++next_run;
+                }
+                if (crossed) {
+                    flush();
+                }
+
+                if (node->augment.epoch + this->window < this->epoch) {
+                    cold.push_back(node);
+                } else {
+                    flush();
+                    keep.push_back(node);
+                }
+            }
+            flush();
+
+            if (spilled == 0) {
+                return 0;
+            }
+
+            // Free the spilled nodes and relink the rest as a balanced tree
+            for (_Node* node : freed) {
+                this->_free_node(node);
+            }
+            this->root = this->_link_balanced(keep, nullptr);
+            this->sz = keep.size();
+            this->_record_reset();
+
+            this->runs.insert(this->runs.end(), added.begin(), added.end());
+            std::ranges::sort(this->runs, [](const _Run& lhs, const _Run& rhs) { return lhs.low < rhs.low; });
+            this->spilled_count += spilled;
+
+            return spilled;
+        }
+
+        // Faults every spilled run back in
+        void restore() {
+            while (!this->runs.empty()) {
+                this->_fault_in(this->runs.size() - 1);
+            }
+        }
+
+    };
+
+    namespace pmr {
+
+        template<class T>
+        using tiered_tree = adt::tiered_tree<T, std::pmr::polymorphic_allocator<T>>;
+
+    } // pmr
+
+} // adt
+
+
+#endif // TIERED_TREE_HPP
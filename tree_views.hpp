@@ -0,0 +1,231 @@
+#ifndef TREE_VIEWS_HPP
+#define TREE_VIEWS_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+
+#include "binary_tree.hpp"
+
+
+namespace adt {
+
+    /* -----------------------------------------------Intersect View------------------------------------------------ */
+    // Lazy intersection of two trees, in ascending order. The iterator walks both trees at once, and whichever side
+    // lags jumps ahead with a finger search (`seek`) instead of stepping, so intersecting a small tree with a huge one
+    // costs O(m log(n / m)) rather than O(n + m).
+    template<class Left, class Right>
+    class intersect_view : public std::ranges::view_interface<intersect_view<Left, Right>> {
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        class iterator {
+        private:
+            /* --------------------------------------------Friends-------------------------------------------------- */
+            friend class intersect_view;
+
+        protected:
+            /* ---------------------------------------------Fields-------------------------------------------------- */
+            const Left* left = nullptr;
+
+            const Right* right = nullptr;
+
+            typename Left::const_iterator lhs;
+
+            typename Right::const_iterator rhs;
+
+            /* ------------------------------------------Constructors----------------------------------------------- */
+            constexpr iterator(const Left* left,
+                               const Right* right,
+                               typename Left::const_iterator lhs,
+                               typename Right::const_iterator rhs) noexcept
+                : left(left), right(right), lhs(lhs), rhs(rhs) {
+                this->_settle();
+            }
+
+            /* --------------------------------------------Methods-------------------------------------------------- */
+            constexpr void _settle() noexcept {
+                // Advance until both sides agree, or either runs out
+                while (this->lhs != this->left->end() && this->rhs != this->right->end()) {
+                    if (*this->lhs < *this->rhs) {
+                        this->lhs = this->left->seek(this->lhs, *this->rhs);
+                    } else if (*this->rhs < *this->lhs) {
+                        this->rhs = this->right->seek(this->rhs, *this->lhs);
+                    } else {
+                        return;
+                    }
+                }
+
+                this->lhs = this->left->end();
+            }
+
+        public:
+            /* -------------------------------------------Definitions----------------------------------------------- */
+            using iterator_category = std::forward_iterator_tag;
+
+            using value_type = typename Left::value_type;
+
+            using difference_type = std::ptrdiff_t;
+
+            using reference = const value_type&;
+
+            using pointer = const value_type*;
+
+            /* ------------------------------------------Constructors----------------------------------------------- */
+            constexpr iterator() noexcept = default;
+
+            /* --------------------------------------Overloaded Operators------------------------------------------- */
+            [[nodiscard]] constexpr reference operator*() const { return *this->lhs; }
+
+            [[nodiscard]] constexpr pointer operator->() const { return &*this->lhs; }
+
+            constexpr iterator& operator++() {
+                ++this->lhs;
+                ++this->rhs;
+                this->_settle();
+                return *this;
+            }
+
+            constexpr iterator operator++(int) {
+                iterator it = *this;
+                ++*this;
+                return it;
+            }
+
+            // Both sides move together, so the left position alone identifies the iterator
+            [[nodiscard]] constexpr bool operator==(const iterator& other) const noexcept {
+                return this->lhs == other.lhs;
+            }
+
+        };
+
+    protected:
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        const Left* left = nullptr;
+
+        const Right* right = nullptr;
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        constexpr intersect_view() noexcept = default;
+
+        constexpr intersect_view(const Left& left, const Right& right) noexcept : left(&left), right(&right) {}
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] constexpr iterator begin() const {
+            return iterator(this->left, this->right, this->left->begin(), this->right->begin());
+        }
+
+        [[nodiscard]] constexpr iterator end() const {
+            return iterator(this->left, this->right, this->left->end(), this->right->end());
+        }
+
+    };
+
+    /* ----------------------------------------------Difference View------------------------------------------------ */
+    // Lazy difference of two trees (the values of `left` missing from `right`), in ascending order. The right side is
+    // only ever moved by finger search to the next left value, so long stretches of `right` are skipped over.
+    template<class Left, class Right>
+    class difference_view : public std::ranges::view_interface<difference_view<Left, Right>> {
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        class iterator {
+        private:
+            /* --------------------------------------------Friends-------------------------------------------------- */
+            friend class difference_view;
+
+        protected:
+            /* ---------------------------------------------Fields-------------------------------------------------- */
+            const Left* left = nullptr;
+
+            const Right* right = nullptr;
+
+            typename Left::const_iterator lhs;
+
+            typename Right::const_iterator rhs;
+
+            /* ------------------------------------------Constructors----------------------------------------------- */
+            constexpr iterator(const Left* left,
+                               const Right* right,
+                               typename Left::const_iterator lhs,
+                               typename Right::const_iterator rhs) noexcept
+                : left(left), right(right), lhs(lhs), rhs(rhs) {
+                this->_settle();
+            }
+
+            /* --------------------------------------------Methods-------------------------------------------------- */
+            constexpr void _settle() noexcept {
+                // Skip left values that the right side also holds
+                while (this->lhs != this->left->end()) {
+                    this->rhs = this->right->seek(this->rhs, *this->lhs);
+                    if (this->rhs == this->right->end() || *this->lhs < *this->rhs) {
+                        return;
+                    }
+                    ++this->lhs;
+                }
+            }
+
+        public:
+            /* -------------------------------------------Definitions----------------------------------------------- */
+            using iterator_category = std::forward_iterator_tag;
+
+            using value_type = typename Left::value_type;
+
+            using difference_type = std::ptrdiff_t;
+
+            using reference = const value_type&;
+
+            using pointer = const value_type*;
+
+            /* ------------------------------------------Constructors----------------------------------------------- */
+            constexpr iterator() noexcept = default;
+
+            /* --------------------------------------Overloaded Operators------------------------------------------- */
+            [[nodiscard]] constexpr reference operator*() const { return *this->lhs; }
+
+            [[nodiscard]] constexpr pointer operator->() const { return &*this->lhs; }
+
+            constexpr iterator& operator++() {
+                ++this->lhs;
+                this->_settle();
+                return *this;
+            }
+
+            constexpr iterator operator++(int) {
+                iterator it = *this;
+                ++*this;
+                return it;
+            }
+
+            [[nodiscard]] constexpr bool operator==(const iterator& other) const noexcept {
+                return this->lhs == other.lhs;
+            }
+
+        };
+
+    protected:
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        const Left* left = nullptr;
+
+        const Right* right = nullptr;
+
+    public:
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        constexpr difference_view() noexcept = default;
+
+        constexpr difference_view(const Left& left, const Right& right) noexcept : left(&left), right(&right) {}
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] constexpr iterator begin() const {
+            return iterator(this->left, this->right, this->left->begin(), this->right->begin());
+        }
+
+        [[nodiscard]] constexpr iterator end() const {
+            return iterator(this->left, this->right, this->left->end(), this->right->end());
+        }
+
+    };
+
+} // adt
+
+
+#endif // TREE_VIEWS_HPP
@@ -0,0 +1,693 @@
+#ifndef VEB_SET_HPP
+#define VEB_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <type_traits>
+#include <concepts>
+#include <bit>
+
+
+namespace adt {
+
+    /* --------------------------------------------------vEB Set---------------------------------------------------- */
+    // A van Emde Boas set over the integers representable in `Bits` bits. Insert, erase, contains, predecessor and
+    // successor all take O(log log U) for a universe of U = 2^Bits keys. Clusters, their pointer tables and summaries
+    // are only allocated once they hold a key and are released as soon as they are empty again, and the recursion
+    // bottoms out in 64-bit words, so sparse sets stay small.
+    template<std::integral T, std::size_t Bits = sizeof(T) * 8, class Allocator = std::allocator<T>>
+    class veb_set {
+        static_assert(Bits > 0 && Bits <= sizeof(T) * 8, "the universe must fit in T");
+
+        // The top-level cluster table has 2^(Bits / 2) entries, which stops being practical past 32-bit universes
+        static_assert(Bits <= 32, "van Emde Boas sets are limited to universes of at most 2^32 keys");
+
+    public:
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using value_type = T;
+
+        using key_type = T;
+
+        using allocator_type = Allocator;
+
+        using size_type = std::size_t;
+
+        using difference_type = std::ptrdiff_t;
+
+        using reference = value_type&;
+
+        using const_reference = const value_type&;
+
+        static constexpr std::size_t universe_bits = Bits;
+
+    protected:
+        /* -------------------------------------------------Node---------------------------------------------------- */
+        using _Key = std::uint64_t;
+
+        static constexpr std::uint8_t leaf_bits = 6;
+
+        struct _Node {
+            /* --------------------------------------------Fields--------------------------------------------------- */
+            // Universe of this node, in bits
+            std::uint8_t bits;
+
+            bool empty;
+
+            // Leaves (at most `leaf_bits` bits) keep their keys in `bitmap`; inner nodes keep `min` out of their
+            // clusters, which is what makes every operation recurse into only one child
+            _Key min;
+
+            _Key max;
+
+            std::uint64_t bitmap;
+
+            _Node* summary;
+
+            _Node** clusters;
+        };
+
+        /* ----------------------------------------------Definitions------------------------------------------------ */
+        using allocator_traits = typename std::allocator_traits<allocator_type>;
+
+        using _NodeAllocator = typename allocator_traits::template rebind_alloc<_Node>;
+
+        using node_allocator_traits = typename std::allocator_traits<_NodeAllocator>;
+
+        using _TableAllocator = typename allocator_traits::template rebind_alloc<_Node*>;
+
+        using table_allocator_traits = typename std::allocator_traits<_TableAllocator>;
+
+        /* ------------------------------------------------Fields--------------------------------------------------- */
+        _Node* root;
+
+        allocator_type allocator;
+
+        _NodeAllocator node_allocator;
+
+        _TableAllocator table_allocator;
+
+        size_type sz;
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] static constexpr _Key _encode(value_type value) noexcept {
+            // Flip the sign bit so that negative values order first, then keep the universe's bits
+            using unsigned_type = std::make_unsigned_t<value_type>;
+            unsigned_type bits = static_cast<unsigned_type>(value);
+            if constexpr (std::is_signed_v<value_type>) {
+                bits ^= unsigned_type(1) << (Bits - 1);
+            }
+
+            if constexpr (Bits < 64) {
+                return static_cast<_Key>(bits) & ((_Key(1) << Bits) - 1);
+            } else {
+                return static_cast<_Key>(bits);
+            }
+        }
+
+        [[nodiscard]] static constexpr value_type _decode(_Key key) noexcept {
+            using unsigned_type = std::make_unsigned_t<value_type>;
+            unsigned_type bits = static_cast<unsigned_type>(key);
+            if constexpr (std::is_signed_v<value_type>) {
+                bits ^= unsigned_type(1) << (Bits - 1);
+
+                // Sign-extend universes narrower than T
+                if constexpr (Bits < sizeof(value_type) * 8) {
+                    if ((bits >> (Bits - 1)) & 1) {
+                        bits |= ~unsigned_type(0) << Bits;
+                    }
+                }
+            }
+
+            return static_cast<value_type>(bits);
+        }
+
+        [[nodiscard]] static constexpr bool _in_universe(value_type value) noexcept {
+            return _decode(_encode(value)) == value;
+        }
+
+        // Smallest and largest values of the universe
+        [[nodiscard]] static constexpr value_type _lowest() noexcept { return _decode(0); }
+
+        [[nodiscard]] static constexpr value_type _highest() noexcept { return _decode((_Key(1) << Bits) - 1); }
+
+        // Inner nodes split their universe into 2^high clusters of 2^low keys; narrow nodes split so that their
+        // clusters are whole 64-bit leaves
+        [[nodiscard]] static constexpr std::uint8_t _low_bits(std::uint8_t bits) noexcept {
+            return bits <= 2 * leaf_bits ? leaf_bits : static_cast<std::uint8_t>(bits / 2);
+        }
+
+        [[nodiscard]] static constexpr bool _is_leaf(const _Node* node) noexcept { return node->bits <= leaf_bits; }
+
+        [[nodiscard]] _Node* _make_node(std::uint8_t bits) {
+            _Node* node = node_allocator_traits::allocate(this->node_allocator, 1);
+            node_allocator_traits::construct(this->node_allocator, node, _Node{bits, true, 0, 0, 0, nullptr, nullptr});
+            return node;
+        }
+
+        void _free_node(_Node* node) noexcept {
+            if (node == nullptr) {
+                return;
+            }
+
+            if (node->clusters != nullptr) {
+                const std::size_t count = std::size_t(1) << (node->bits - _low_bits(node->bits));
+                for (std::size_t i = 0; i < count; ++i) {
+                    this->_free_node(node->clusters[i]);
+                }
+                table_allocator_traits::deallocate(this->table_allocator, node->clusters, count);
+            }
+            this->_free_node(node->summary);
+
+            node_allocator_traits::destroy(this->node_allocator, node);
+            node_allocator_traits::deallocate(this->node_allocator, node, 1);
+        }
+
+        [[nodiscard]] _Node* _clone_node(const _Node* other) {
+            if (other == nullptr) {
+                return nullptr;
+            }
+
+            _Node* node = this->_make_node(other->bits);
+            node->empty = other->empty;
+            node->min = other->min;
+            node->max = other->max;
+            node->bitmap = other->bitmap;
+            node->summary = this->_clone_node(other->summary);
+
+            if (other->clusters != nullptr) {
+                const std::size_t count = std::size_t(1) << (other->bits - _low_bits(other->bits));
+                node->clusters = table_allocator_traits::allocate(this->table_allocator, count);
+                for (std::size_t i = 0; i < count; ++i) {
+                    node->clusters[i] = this->_clone_node(other->clusters[i]);
+                }
+            }
+
+            return node;
+        }
+
+        [[nodiscard]] static constexpr bool _empty(const _Node* node) noexcept {
+            return node == nullptr || (_is_leaf(node) ? node->bitmap == 0 : node->empty);
+        }
+
+        [[nodiscard]] static constexpr _Key _min(const _Node* node) noexcept {
+            return _is_leaf(node) ? static_cast<_Key>(std::countr_zero(node->bitmap)) : node->min;
+        }
+
+        [[nodiscard]] static constexpr _Key _max(const _Node* node) noexcept {
+            return _is_leaf(node) ? static_cast<_Key>(63 - std::countl_zero(node->bitmap)) : node->max;
+        }
+
+        [[nodiscard]] static bool _contains(const _Node* node, _Key key) noexcept {
+            while (!_empty(node)) {
+                if (_is_leaf(node)) {
+                    return (node->bitmap >> key) & 1;
+                }
+
+                if (key == node->min || key == node->max) {
+                    return true;
+                }
+
+                const std::uint8_t low = _low_bits(node->bits);
+                if (node->clusters == nullptr) {
+                    return false;
+                }
+
+                node = node->clusters[key >> low];
+                key &= (_Key(1) << low) - 1;
+            }
+
+            return false;
+        }
+
+        // `key` must not be in the set yet
+        void _insert(_Node* node, _Key key) {
+            if (_is_leaf(node)) {
+                node->bitmap |= std::uint64_t(1) << key;
+                return;
+            }
+
+            if (node->empty) {
+                // An empty node only needs its min and max set; no cluster is touched
+                node->empty = false;
+                node->min = key;
+                node->max = key;
+                return;
+            }
+
+            if (key < node->min) {
+                std::swap(key, node->min);
+            }
+            if (key > node->max) {
+                node->max = key;
+            }
+
+            const std::uint8_t low = _low_bits(node->bits);
+            const _Key high = key >> low;
+            const _Key offset = key & ((_Key(1) << low) - 1);
+
+            if (node->clusters == nullptr) {
+                const std::size_t count = std::size_t(1) << (node->bits - low);
+                node->clusters = table_allocator_traits::allocate(this->table_allocator, count);
+                for (std::size_t i = 0; i < count; ++i) {
+                    node->clusters[i] = nullptr;
+                }
+            }
+            if (node->clusters[high] == nullptr) {
+                node->clusters[high] = this->_make_node(low);
+            }
+
+            _Node* cluster = node->clusters[high];
+            if (_empty(cluster)) {
+                // The cluster insert below is O(1), so only the summary insert recurses
+                if (node->summary == nullptr) {
+                    node->summary = this->_make_node(static_cast<std::uint8_t>(node->bits - low));
+                }
+                this->_insert(node->summary, high);
+            }
+            this->_insert(cluster, offset);
+        }
+
+        // `key` must be in the set
+        void _erase(_Node* node, _Key key) noexcept {
+            if (_is_leaf(node)) {
+                node->bitmap &= ~(std::uint64_t(1) << key);
+                return;
+            }
+
+            if (node->min == node->max) {
+                node->empty = true;
+                return;
+            }
+
+            const std::uint8_t low = _low_bits(node->bits);
+
+            if (key == node->min) {
+                // Pull the smallest clustered key up to become the new minimum, and erase it from its cluster
+                const _Key high = _min(node->summary);
+                key = (high << low) | _min(node->clusters[high]);
+                node->min = key;
+            }
+
+            const _Key high = key >> low;
+            _Node* cluster = node->clusters[high];
+            this->_erase(cluster, key & ((_Key(1) << low) - 1));
+
+            if (_empty(cluster)) {
+                // The cluster just lost its only key, so the summary erase is the only real recursion
+                this->_free_node(cluster);
+                node->clusters[high] = nullptr;
+                this->_erase(node->summary, high);
+
+                if (key == node->max) {
+                    if (_empty(node->summary)) {
+                        node->max = node->min;
+                    } else {
+                        const _Key last = _max(node->summary);
+                        node->max = (last << low) | _max(node->clusters[last]);
+                    }
+                }
+            } else if (key == node->max) {
+                node->max = (high << low) | _max(cluster);
+            }
+
+            // Drop the tables of nodes that are back to holding only their minimum
+            if (node->min == node->max && node->clusters != nullptr) {
+                const std::size_t count = std::size_t(1) << (node->bits - low);
+                table_allocator_traits::deallocate(this->table_allocator, node->clusters, count);
+                node->clusters = nullptr;
+                this->_free_node(node->summary);
+                node->summary = nullptr;
+            }
+        }
+
+        [[nodiscard]] static std::optional<_Key> _successor(const _Node* node, _Key key) noexcept {
+            if (_empty(node)) {
+                return std::nullopt;
+            }
+
+            if (_is_leaf(node)) {
+                const std::uint64_t above = key >= 63 ? 0 : node->bitmap & (~std::uint64_t(0) << (key + 1));
+                return above != 0 ? std::optional<_Key>(std::countr_zero(above)) : std::nullopt;
+            }
+
+            if (key < node->min) {
+                return node->min;
+            }
+            if (key >= node->max) {
+                return std::nullopt;
+            }
+
+            const std::uint8_t low = _low_bits(node->bits);
+            const _Key high = key >> low;
+            const _Key offset = key & ((_Key(1) << low) - 1);
+
+            // Either the successor is in the key's own cluster, or it is the minimum of the next non-empty one
+            const _Node* cluster = node->clusters != nullptr ? node->clusters[high] : nullptr;
+            if (!_empty(cluster) && offset < _max(cluster)) {
+                return (high << low) | *_successor(cluster, offset);
+            }
+
+            const std::optional<_Key> next = _successor(node->summary, high);
+            if (!next) {
+                return std::nullopt;
+            }
+
+            return (*next << low) | _min(node->clusters[*next]);
+        }
+
+        [[nodiscard]] static std::optional<_Key> _predecessor(const _Node* node, _Key key) noexcept {
+            if (_empty(node)) {
+                return std::nullopt;
+            }
+
+            if (_is_leaf(node)) {
+                const std::uint64_t below = node->bitmap & ((std::uint64_t(1) << key) - 1);
+                return below != 0 ? std::optional<_Key>(63 - std::countl_zero(below)) : std::nullopt;
+            }
+
+            if (key > node->max) {
+                return node->max;
+            }
+            if (key <= node->min) {
+                return std::nullopt;
+            }
+
+            const std::uint8_t low = _low_bits(node->bits);
+            const _Key high = key >> low;
+            const _Key offset = key & ((_Key(1) << low) - 1);
+
+            const _Node* cluster = node->clusters != nullptr ? node->clusters[high] : nullptr;
+            if (!_empty(cluster) && offset > _min(cluster)) {
+                return (high << low) | *_predecessor(cluster, offset);
+            }
+
+            // The minimum lives outside the clusters, so it is the fallback when no earlier cluster has keys
+            const std::optional<_Key> previous = node->summary != nullptr ? _predecessor(node->summary, high)
+                                                                          : std::nullopt;
+            if (!previous) {
+                return node->min;
+            }
+
+            return (*previous << low) | _max(node->clusters[*previous]);
+        }
+
+    public:
+        /* --------------------------------------------Constant Iterator-------------------------------------------- */
+        class const_iterator {
+        private:
+            /* --------------------------------------------Friends-------------------------------------------------- */
+            friend class veb_set;
+
+        protected:
+            /* ---------------------------------------------Fields-------------------------------------------------- */
+            const veb_set* set;
+
+            std::optional<typename veb_set::value_type> value;
+
+            /* ------------------------------------------Constructors----------------------------------------------- */
+            constexpr const_iterator(const veb_set* set, std::optional<typename veb_set::value_type> value) noexcept
+                : set(set), value(value) {}
+
+        public:
+            /* -------------------------------------------Definitions----------------------------------------------- */
+            using iterator_category = std::bidirectional_iterator_tag;
+
+            using value_type = typename veb_set::value_type;
+
+            using difference_type = typename veb_set::difference_type;
+
+            using reference = const value_type&;
+
+            using pointer = const value_type*;
+
+            /* ------------------------------------------Constructors----------------------------------------------- */
+            constexpr const_iterator() noexcept : set(nullptr) {}
+
+            /* ---------------------------------------Overloaded Operators------------------------------------------ */
+            [[nodiscard]] constexpr bool operator==(const const_iterator& other) const noexcept {
+                return this->value == other.value;
+            }
+
+            [[nodiscard]] constexpr reference operator*() const noexcept { return *this->value; }
+
+            [[nodiscard]] constexpr pointer operator->() const noexcept { return &*this->value; }
+
+            const_iterator& operator++() noexcept {
+                this->value = this->set->successor(*this->value);
+                return *this;
+            }
+
+            const_iterator operator++(int) noexcept {
+                const_iterator previous = *this;
+                ++(*this);
+                return previous;
+            }
+
+            const_iterator& operator--() noexcept {
+                // Decrementing `end()` lands on the largest key
+                this->value = this->value ? this->set->predecessor(*this->value) : this->set->max();
+                return *this;
+            }
+
+            const_iterator operator--(int) noexcept {
+                const_iterator previous = *this;
+                --(*this);
+                return previous;
+            }
+
+        };
+
+        using iterator = const_iterator;
+
+        /* ----------------------------------------------Constructors----------------------------------------------- */
+        veb_set() : veb_set(allocator_type()) {}
+
+        explicit veb_set(const allocator_type& allocator)
+            : root(nullptr), allocator(allocator), node_allocator(allocator), table_allocator(allocator), sz(0) {
+            this->root = this->_make_node(static_cast<std::uint8_t>(Bits));
+        }
+
+        veb_set(std::initializer_list<value_type> values, const allocator_type& allocator = allocator_type())
+            : veb_set(allocator) {
+            this->insert(values);
+        }
+
+        veb_set(const veb_set& other)
+            : root(nullptr),
+              allocator(allocator_traits::select_on_container_copy_construction(other.allocator)),
+              node_allocator(this->allocator),
+              table_allocator(this->allocator),
+              sz(other.sz) {
+            this->root = this->_clone_node(other.root);
+        }
+
+        // The source is left without a root, which every entry point treats as an empty set
+        veb_set(veb_set&& other) noexcept
+            : root(std::exchange(other.root, nullptr)),
+              allocator(std::move(other.allocator)),
+              node_allocator(std::move(other.node_allocator)),
+              table_allocator(std::move(other.table_allocator)),
+              sz(std::exchange(other.sz, 0)) {}
+
+        /* -----------------------------------------------Destructor------------------------------------------------ */
+        ~veb_set() noexcept { this->_free_node(this->root); }
+
+        /* ------------------------------------------Overloaded Operators------------------------------------------- */
+        veb_set& operator=(const veb_set& other) {
+            if (this == &other) {
+                return *this;
+            }
+
+            this->_free_node(this->root);
+            this->root = nullptr;
+            this->sz = 0;
+
+            if constexpr (allocator_traits::propagate_on_container_copy_assignment::value) {
+                this->allocator = other.allocator;
+                this->node_allocator = _NodeAllocator(this->allocator);
+                this->table_allocator = _TableAllocator(this->allocator);
+            }
+
+            this->root = this->_clone_node(other.root);
+            this->sz = other.sz;
+
+            return *this;
+        }
+
+        veb_set& operator=(veb_set&& other)
+            noexcept(allocator_traits::propagate_on_container_move_assignment::value ||
+                     allocator_traits::is_always_equal::value) {
+            if (this == &other) {
+                return *this;
+            }
+
+            this->_free_node(this->root);
+            this->root = nullptr;
+            this->sz = 0;
+
+            if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+                // Take over the allocator along with the nodes it owns
+                this->allocator = std::move(other.allocator);
+                this->node_allocator = std::move(other.node_allocator);
+                this->table_allocator = std::move(other.table_allocator);
+                this->root = std::exchange(other.root, nullptr);
+                this->sz = std::exchange(other.sz, 0);
+            } else if (this->allocator == other.allocator) {
+                this->root = std::exchange(other.root, nullptr);
+                this->sz = std::exchange(other.sz, 0);
+            } else {
+                // The allocators differ and may not propagate, so copy the nodes into our own allocator
+                this->root = this->_clone_node(other.root);
+                this->sz = other.sz;
+            }
+
+            return *this;
+        }
+
+        [[nodiscard]] bool operator==(const veb_set& other) const noexcept {
+            if (this->sz != other.sz) {
+                return false;
+            }
+
+            for (const_iterator lhs = this->begin(), rhs = other.begin(); lhs != this->end(); ++lhs, ++rhs) {
+                if (*lhs != *rhs) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /* ------------------------------------------------Methods-------------------------------------------------- */
+        [[nodiscard]] size_type size() const noexcept { return this->sz; }
+
+        [[nodiscard]] size_type max_size() const noexcept { return size_type(1) << Bits; }
+
+        [[nodiscard]] bool empty() const noexcept { return this->sz == 0; }
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept { return this->allocator; }
+
+        [[nodiscard]] const_iterator begin() const noexcept { return {this, this->min()}; }
+
+        [[nodiscard]] const_iterator end() const noexcept { return {this, std::nullopt}; }
+
+        [[nodiscard]] const_iterator cbegin() const noexcept { return this->begin(); }
+
+        [[nodiscard]] const_iterator cend() const noexcept { return this->end(); }
+
+        void swap(veb_set& other) noexcept {
+            using std::swap;
+            if constexpr (allocator_traits::propagate_on_container_swap::value) {
+                swap(this->allocator, other.allocator);
+                swap(this->node_allocator, other.node_allocator);
+                swap(this->table_allocator, other.table_allocator);
+            }
+            swap(this->root, other.root);
+            swap(this->sz, other.sz);
+        }
+
+        friend void swap(veb_set& lhs, veb_set& rhs) noexcept { lhs.swap(rhs); }
+
+        void clear() noexcept {
+            this->_free_node(this->root);
+            this->root = this->_make_node(static_cast<std::uint8_t>(Bits));
+            this->sz = 0;
+        }
+
+        void insert(std::initializer_list<value_type> values) {
+            for (const value_type value : values) {
+                this->insert(value);
+            }
+        }
+
+        // Values outside the universe are rejected
+        bool insert(value_type value) {
+            if (!_in_universe(value) || this->contains(value)) {
+                return false;
+            }
+
+            if (this->root == nullptr) {
+                this->root = this->_make_node(static_cast<std::uint8_t>(Bits));
+            }
+
+            this->_insert(this->root, _encode(value));
+            ++this->sz;
+
+            return true;
+        }
+
+        bool erase(value_type value) noexcept {
+            if (!this->contains(value)) {
+                return false;
+            }
+
+            this->_erase(this->root, _encode(value));
+            --this->sz;
+
+            return true;
+        }
+
+        [[nodiscard]] bool contains(value_type value) const noexcept {
+            return _in_universe(value) && _contains(this->root, _encode(value));
+        }
+
+        [[nodiscard]] const_iterator find(value_type value) const noexcept {
+            return this->contains(value) ? const_iterator(this, value) : this->end();
+        }
+
+        [[nodiscard]] std::optional<value_type> min() const noexcept {
+            return _empty(this->root) ? std::nullopt : std::optional<value_type>(_decode(_min(this->root)));
+        }
+
+        [[nodiscard]] std::optional<value_type> max() const noexcept {
+            return _empty(this->root) ? std::nullopt : std::optional<value_type>(_decode(_max(this->root)));
+        }
+
+        // Smallest key strictly greater than `value`
+        [[nodiscard]] std::optional<value_type> successor(value_type value) const noexcept {
+            // Values outside the universe lie entirely below or above it
+            if (!_in_universe(value)) {
+                return value < _lowest() ? this->min() : std::nullopt;
+            }
+
+            const std::optional<_Key> key = _successor(this->root, _encode(value));
+            return key ? std::optional<value_type>(_decode(*key)) : std::nullopt;
+        }
+
+        // Largest key strictly less than `value`
+        [[nodiscard]] std::optional<value_type> predecessor(value_type value) const noexcept {
+            if (!_in_universe(value)) {
+                return _highest() < value ? this->max() : std::nullopt;
+            }
+
+            const std::optional<_Key> key = _predecessor(this->root, _encode(value));
+            return key ? std::optional<value_type>(_decode(*key)) : std::nullopt;
+        }
+
+        [[nodiscard]] const_iterator lower_bound(value_type value) const noexcept {
+            return this->contains(value) ? const_iterator(this, value) : const_iterator(this, this->successor(value));
+        }
+
+        [[nodiscard]] const_iterator upper_bound(value_type value) const noexcept {
+            return const_iterator(this, this->successor(value));
+        }
+
+    };
+
+    namespace pmr {
+
+        template<std::integral T, std::size_t Bits = sizeof(T) * 8>
+        using veb_set = adt::veb_set<T, Bits, std::pmr::polymorphic_allocator<T>>;
+
+    } // pmr
+
+} // adt
+
+
+#endif // VEB_SET_HPP